@@ -9,6 +9,19 @@
 // optimal for merge sort] 
 // 
 #include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <climits>
+#include <cstdint>
+#include <thread>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SEARCH_SIMD 1
+#define PREFETCH(p) _mm_prefetch((const char*)(p), _MM_HINT_T0)
+#else
+#define SEARCH_SIMD 0
+#define PREFETCH(p) ((void)0)
+#endif
 using namespace std;
 
 
@@ -41,6 +54,82 @@ Node::Node() {
 	p_next = NULL;
 }
 
+//
+// Search trace policies:
+//
+// BSearch reports every probe to a trace object chosen at compile time.
+// Each policy has one function, Probe(list, index, depth), called with the
+// index being "searched" and the recursion depth
+//
+// NoTrace: Does nothing [default, compiles away completely]
+// PrintTrace: Prints the probed value, like the original homework version
+// RingTrace<N>: Records the last N probed indexes in a ring buffer
+// CountTrace: Counts probes and the deepest level reached
+//
+class NoTrace {
+public:
+	void Probe(const int*, int, int) {}
+};
+
+class PrintTrace {
+public:
+	void Probe(const int* list, int index, int) {
+		cout << list[index];
+	}
+};
+
+template <int N = 64>
+class RingTrace {
+private:
+	int buffer[N];
+	int count;
+public:
+	void Probe(const int*, int index, int) {
+		buffer[count % N] = index;				//Overwrite the oldest entry once the buffer is full
+		count++;
+	}
+
+	// Total number of probes seen [may be more than N]
+	int Count() {
+		return count;
+	}
+
+	// Returns the i-th probe still in the buffer, oldest first
+	// [i goes from 0 to min(Count(), N) - 1]
+	int Get(int i) {
+		int start = (count > N) ? count - N : 0;
+		return buffer[(start + i) % N];
+	}
+
+	RingTrace() {
+		count = 0;
+	}
+};
+
+class CountTrace {
+private:
+	int probes;
+	int maxDepth;
+public:
+	void Probe(const int*, int, int depth) {
+		probes++;
+		if (depth > maxDepth) maxDepth = depth;
+	}
+
+	int Get_Probes() {
+		return probes;
+	}
+
+	int Get_MaxDepth() {
+		return maxDepth;
+	}
+
+	CountTrace() {
+		probes = 0;
+		maxDepth = 0;
+	}
+};
+
 //
 // Recursive binary search function:
 // 
@@ -49,33 +138,557 @@ Node::Node() {
 // in the list. It returns -1 if the 
 // key is not in the list. 
 // 
-// For testing purposes, the function also
-// prints out the index that is being "searched"
-// at every iteration
+// Every index that is being "searched" is passed
+// to trace.Probe() [Use PrintTrace to print them
+// out for testing, NoTrace costs nothing]
 // 
 // 
-int BSearch(int* list, int start, int end, int key) {
+template <class Trace>
+int BSearch(int* list, int start, int end, int key, Trace& trace, int depth = 0) {
 	if (start > end) {
 		if (list[start] == key) {					//Handles the case when start and end converge to one element:
-			cout << list[start];
-			return start;							//If the element is found, print element and return its index, if not, return -1
+			trace.Probe(list, start, depth);
+			return start;							//If the element is found, trace element and return its index, if not, return -1
 		}
 		else return -1;
 	}
 
 	int test = (start + end) / 2;					//Initialize Test Value Halfway between start and end indexes
-	cout << list[test];
+	trace.Probe(list, test, depth);
 	if (key == list[test]) {
 		return test;								//If key value found here, return test [Index of value]
 	}
 	else if (key > list[test]) {
-		return BSearch(list, test + 1, end, key);	//If key value is greater than current test, redo search with right sublist
+		return BSearch(list, test + 1, end, key, trace, depth + 1);	//If key value is greater than current test, redo search with right sublist
 	}
 	else{
-		return BSearch(list, start, test - 1, key); //If key value is less than current test, redo search with left sublist
+		return BSearch(list, start, test - 1, key, trace, depth + 1); //If key value is less than current test, redo search with left sublist
+	}
+}
+
+//
+// Untraced binary search [uses NoTrace]
+//
+int BSearch(int* list, int start, int end, int key) {
+	NoTrace trace;
+	return BSearch(list, start, end, key, trace);
+}
+
+
+
+//
+// Static search layouts:
+//
+// BSearch is fine for an 11 element homework array, but on large read-only
+// key sets every level costs a branch mispredict and a cache miss. The
+// functions/classes below search the same sorted data faster:
+//
+// BranchlessLowerBound: Same sorted array, loop has no unpredictable branch
+// EytzingerArray: Keys stored in breadth-first (heap) order so the next few
+//                 levels of the search are in one cache line and can be prefetched
+// STree: Static B-tree with 16 keys per node [one cache line], each node is
+//        checked with SIMD compares instead of one comparison per level
+//
+// All of them return indexes into the original sorted array
+//
+
+//
+// Returns a pointer aligned to a 64 byte cache line inside "raw"
+// [raw must have 64 extra bytes allocated]
+//
+int* AlignToCacheLine(int* raw) {
+	uintptr_t addr = (uintptr_t)raw;
+	return (int*)((addr + 63) & ~(uintptr_t)63);
+}
+
+//
+// Branchless lower bound: Returns the index of the first element
+// of the sorted list that is >= key [n if every element is smaller]
+//
+// The loop always runs log2(n) times and the comparison only picks
+// which half to keep, so the compiler can use a conditional move
+//
+int BranchlessLowerBound(const int* list, int n, int key) {
+	if (n <= 0) return 0;
+	const int* base = list;
+	int len = n;
+	while (len > 1) {
+		int half = len / 2;
+		PREFETCH(base + half / 2);									//Prefetch the midpoints of both possible halves
+		PREFETCH(base + half + half / 2);
+		base = (base[half - 1] < key) ? base + half : base;			//Keep the right half only if the left half is all smaller
+		len -= half;
+	}
+	return (int)(base - list) + (*base < key);
+}
+
+//
+// Galloping (exponential) search: Returns the index of the first element
+// of the sorted list that is >= key [n if every element is smaller]
+//
+// Starts at "hint" and probes hint +- 1, 2, 4, 8 ... until it passes the
+// key, then binary searches only the last gap. A key d positions away from
+// the hint takes about 2*log2(d) probes instead of log2(n), so lookups near
+// the previous result are cheap
+//
+template <class Trace>
+int GallopLowerBound(const int* list, int n, int key, int hint, Trace& trace) {
+	if (n <= 0) return 0;
+	if (hint < 0) hint = 0;
+	if (hint > n - 1) hint = n - 1;
+
+	int lo, hi;												//Answer is in [lo, hi]: list[lo - 1] < key, list[hi] >= key or hi == n
+	int depth = 0;
+	trace.Probe(list, hint, depth++);
+	if (list[hint] < key) {
+		lo = hint + 1;										//Gallop right until an element >= key is found
+		hi = n;
+		for (int step = 1; hint + step < n; step *= 2) {
+			trace.Probe(list, hint + step, depth++);
+			if (list[hint + step] >= key) {
+				hi = hint + step;
+				break;
+			}
+			lo = hint + step + 1;
+		}
+	}
+	else {
+		hi = hint;											//Gallop left until an element < key is found
+		lo = 0;
+		for (int step = 1; hint - step >= 0; step *= 2) {
+			trace.Probe(list, hint - step, depth++);
+			if (list[hint - step] < key) {
+				lo = hint - step + 1;
+				break;
+			}
+			hi = hint - step;
+		}
+	}
+
+	while (lo < hi) {										//Binary search inside the last gap
+		int mid = lo + (hi - lo) / 2;
+		trace.Probe(list, mid, depth++);
+		if (list[mid] < key) lo = mid + 1;
+		else hi = mid;
 	}
+	return lo;
+}
+
+//
+// Galloping search: Returns index of key, or -1 if it is not in the list
+//
+template <class Trace>
+int GallopSearch(const int* list, int n, int key, int hint, Trace& trace) {
+	int i = GallopLowerBound(list, n, key, hint, trace);
+	return (i < n && list[i] == key) ? i : -1;
+}
+
+int GallopSearch(const int* list, int n, int key, int hint) {
+	NoTrace trace;
+	return GallopSearch(list, n, key, hint, trace);
+}
+
+//
+// Interpolation search: Returns index of key, or -1 if it is not in the list
+//
+// Guesses the position from the key's value [like opening a phone book near
+// the right letter], which takes about log2(log2(n)) probes when the keys
+// are spread evenly. If a guess does not at least halve the range [keys are
+// not uniform], a normal binary search step follows it, so the search never
+// takes more than about twice as many probes as binary search
+//
+template <class Trace>
+int InterpolationSearch(const int* list, int n, int key, Trace& trace) {
+	int lo = 0;
+	int hi = n - 1;
+	int depth = 0;
+	while (lo <= hi && key >= list[lo] && key <= list[hi]) {
+		if (list[hi] == list[lo]) {
+			trace.Probe(list, lo, depth++);
+			return lo;										//Every key in the range is equal [and equals key]
+		}
+
+		int range = hi - lo;
+		int pos = lo + (int)((double)((long long)key - list[lo]) / ((long long)list[hi] - list[lo]) * range);
+		trace.Probe(list, pos, depth++);
+		if (list[pos] == key) return pos;
+		if (list[pos] < key) lo = pos + 1;
+		else hi = pos - 1;
+
+		if (lo <= hi && hi - lo > range / 2) {
+			int mid = lo + (hi - lo) / 2;					//Guess was poor: fall back to one binary step
+			trace.Probe(list, mid, depth++);
+			if (list[mid] == key) return mid;
+			if (list[mid] < key) lo = mid + 1;
+			else hi = mid - 1;
+		}
+	}
+	return -1;
+}
+
+int InterpolationSearch(const int* list, int n, int key) {
+	NoTrace trace;
+	return InterpolationSearch(list, n, key, trace);
+}
+
+//
+// Search strategies that can be chosen per array [see SortedSearch]
+//
+enum SearchStrategy {
+	SEARCH_BINARY,			// Branchless binary search, best for random lookups
+	SEARCH_GALLOP,			// Galloping search from the previous result, best for nearby lookups
+	SEARCH_INTERPOLATION	// Interpolation search, best for evenly spread keys
+};
+
+//
+// SortedSearch Class: Searches one sorted array with the strategy chosen
+// for it, remembering the last position for galloping
+//
+class SortedSearch {
+private:
+	const int* list;
+	int n;
+	SearchStrategy strategy;
+
+	// Lower bound of the previous search [starting point for SEARCH_GALLOP]
+	int hint;
+
+public:
+	//
+	// Uses the sorted array "sorted" of size n [not copied] with strategy s
+	//
+	void Attach(const int* sorted, int size, SearchStrategy s);
+
+	//
+	// Returns index of key, or -1 if it is not in the array
+	//
+	int Search(int key);
+
+	SortedSearch();
+};
+
+SortedSearch::SortedSearch() {
+	list = NULL;
+	n = 0;
+	strategy = SEARCH_BINARY;
+	hint = 0;
 }
 
+void SortedSearch::Attach(const int* sorted, int size, SearchStrategy s) {
+	list = sorted;
+	n = size;
+	strategy = s;
+	hint = 0;
+}
+
+int SortedSearch::Search(int key) {
+	if (strategy == SEARCH_INTERPOLATION) {
+		return InterpolationSearch(list, n, key);
+	}
+	int i;
+	if (strategy == SEARCH_GALLOP) {
+		NoTrace trace;
+		i = GallopLowerBound(list, n, key, hint, trace);
+		hint = i;											//Next search starts where this one ended
+	}
+	else {
+		i = BranchlessLowerBound(list, n, key);
+	}
+	return (i < n && list[i] == key) ? i : -1;
+}
+
+//
+// Batched binary search: Searches the sorted list for m keys at once and
+// writes the index of each key [or -1 if it is not in the list] to out
+//
+// Searching one key at a time waits for each cache miss before issuing the
+// next one. Here the keys are processed in groups of BATCH_GROUP that advance
+// one level together: every search in the group prefetches its next probe,
+// so up to BATCH_GROUP memory loads are in flight instead of one
+//
+// The branchless loop makes the same number of steps for every key,
+// so all searches in a group stay in lockstep
+//
+const int BATCH_GROUP = 16;
+
+void BSearchBatch(const int* list, int n, const int* keys, int m, int* out) {
+	const int* base[BATCH_GROUP];
+	for (int g = 0; g < m; g += BATCH_GROUP) {
+		int count = (m - g < BATCH_GROUP) ? m - g : BATCH_GROUP;
+		const int* groupKeys = keys + g;
+		if (n <= 0) {
+			for (int i = 0; i < count; i++) out[g + i] = -1;
+			continue;
+		}
+
+		for (int i = 0; i < count; i++) base[i] = list;
+		int len = n;
+		while (len > 1) {
+			int half = len / 2;
+			for (int i = 0; i < count; i++) {
+				base[i] = (base[i][half - 1] < groupKeys[i]) ? base[i] + half : base[i];	//One level of every search in the group
+			}
+			len -= half;
+			for (int i = 0; i < count; i++) {
+				PREFETCH(base[i] + len / 2 - 1);			//Issue the next probe of every search before any of them is needed
+			}
+		}
+
+		for (int i = 0; i < count; i++) {
+			int idx = (int)(base[i] - list) + (*base[i] < groupKeys[i]);
+			out[g + i] = (idx < n && list[idx] == groupKeys[i]) ? idx : -1;
+		}
+	}
+}
+
+//
+// EytzingerArray Class: Stores a sorted array in breadth-first order
+// [node k has children 2k and 2k+1, index 0 is unused]
+//
+class EytzingerArray {
+private:
+	int n;
+	int* raw;			// Allocated memory [freed in destructor]
+	int* keys;			// Cache line aligned keys in BFS order
+	int* rank;			// rank[k] = index of keys[k] in the original sorted array
+
+	// Fills the layout by an in-order walk of the implicit tree
+	int Fill(const int* sorted, int i, int k);
+
+	// Returns the BFS index of the first key >= key [0 if none]
+	int FindNode(int key);
+
+public:
+	//
+	// Converts a sorted array of n keys into the Eytzinger layout
+	//
+	void Build(const int* sorted, int size);
+
+	//
+	// Returns the sorted index of the first key >= key [n if none]
+	//
+	int LowerBound(int key);
+
+	//
+	// Returns the sorted index of key, or -1 if it is not stored [same as BSearch]
+	//
+	int Search(int key);
+
+	//
+	// Searches m keys at once, writing each Search result to out
+	// [groups of BATCH_GROUP searches advance level by level together]
+	//
+	void SearchBatch(const int* keys, int m, int* out);
+
+	EytzingerArray();
+	~EytzingerArray();
+};
+
+EytzingerArray::EytzingerArray() {
+	n = 0;
+	raw = NULL;
+	keys = NULL;
+	rank = NULL;
+}
+
+EytzingerArray::~EytzingerArray() {
+	delete[] raw;
+	delete[] rank;
+}
+
+int EytzingerArray::Fill(const int* sorted, int i, int k) {
+	if (k <= n) {
+		i = Fill(sorted, i, 2 * k);						//Left subtree holds the smaller keys, then this node, then right subtree
+		keys[k] = sorted[i];
+		rank[k] = i++;
+		i = Fill(sorted, i, 2 * k + 1);
+	}
+	return i;
+}
+
+void EytzingerArray::Build(const int* sorted, int size) {
+	delete[] raw;
+	delete[] rank;
+	n = size;
+	raw = new int[n + 1 + 16];							//16 extra ints so the keys can start on a cache line
+	keys = AlignToCacheLine(raw);
+	rank = new int[n + 1];
+	keys[0] = INT_MIN;
+	rank[0] = n;										//Index 0 is reached when no key is >= search key -> "not found" rank n
+	Fill(sorted, 0, 1);
+}
+
+int EytzingerArray::FindNode(int key) {
+	int k = 1;
+	while (k <= n) {
+		PREFETCH(keys + k * 16);						//Prefetch 4 levels ahead [16 descendants of k share one cache line]
+		k = 2 * k + (keys[k] < key);					//Go right if this key is smaller, no branch needed
+	}
+	while (k & 1) k >>= 1;								//Undo the trailing right turns and the last left turn:
+	k >>= 1;											//what remains is the last node where we went left [the answer]
+	return k;
+}
+
+int EytzingerArray::LowerBound(int key) {
+	return rank[FindNode(key)];
+}
+
+int EytzingerArray::Search(int key) {
+	int k = FindNode(key);
+	return (k != 0 && keys[k] == key) ? rank[k] : -1;
+}
+
+void EytzingerArray::SearchBatch(const int* keys_in, int m, int* out) {
+	int k[BATCH_GROUP];
+	for (int g = 0; g < m; g += BATCH_GROUP) {
+		int count = (m - g < BATCH_GROUP) ? m - g : BATCH_GROUP;
+		const int* groupKeys = keys_in + g;
+		for (int i = 0; i < count; i++) k[i] = 1;
+
+		bool active = (n >= 1);
+		while (active) {
+			active = false;									//Searches can end one level apart, so loop until all of them are done
+			for (int i = 0; i < count; i++) {
+				if (k[i] <= n) {
+					k[i] = 2 * k[i] + (keys[k[i]] < groupKeys[i]);
+					PREFETCH(keys + k[i] * 16);
+					active = true;
+				}
+			}
+		}
+
+		for (int i = 0; i < count; i++) {
+			int node = k[i];
+			while (node & 1) node >>= 1;
+			node >>= 1;
+			out[g + i] = (node != 0 && keys[node] == groupKeys[i]) ? rank[node] : -1;
+		}
+	}
+}
+
+//
+// STree Class: Static B-tree with 16 keys per node, stored implicitly
+// [node k has children k*17+1 ... k*17+17]
+//
+// Each node is exactly one cache line, so a search takes log17(n) cache
+// misses instead of log2(n), and the 16 keys are compared with SIMD
+//
+class STree {
+private:
+	static const int B = 16;
+	int n;
+	int blocks;
+	int* raw;			// Allocated memory [freed in destructor]
+	int* keys;			// Cache line aligned nodes, empty slots hold INT_MAX
+	int* rank;			// rank[i] = index of keys[i] in the original sorted array
+
+	// Returns the number of keys in node k that are smaller than key
+	int RankInNode(int k, int key);
+
+	// Fills the nodes by an in-order walk of the implicit tree
+	int Fill(const int* sorted, int i, int k);
+
+public:
+	//
+	// Converts a sorted array of n keys into the S-tree layout
+	//
+	void Build(const int* sorted, int size);
+
+	//
+	// Returns the sorted index of the first key >= key [n if none]
+	//
+	int LowerBound(int key);
+
+	//
+	// Returns the sorted index of key, or -1 if it is not stored [same as BSearch]
+	//
+	int Search(int key);
+
+	STree();
+	~STree();
+};
+
+STree::STree() {
+	n = 0;
+	blocks = 0;
+	raw = NULL;
+	keys = NULL;
+	rank = NULL;
+}
+
+STree::~STree() {
+	delete[] raw;
+	delete[] rank;
+}
+
+int STree::Fill(const int* sorted, int i, int k) {
+	if (k < blocks) {
+		for (int j = 0; j < B; j++) {
+			i = Fill(sorted, i, k * (B + 1) + j + 1);	//Child j holds the keys smaller than key j of this node
+			if (i < n) {
+				keys[k * B + j] = sorted[i];
+				rank[k * B + j] = i++;
+			}
+			else {
+				keys[k * B + j] = INT_MAX;				//Padding: never smaller than a search key
+				rank[k * B + j] = n;
+			}
+		}
+		i = Fill(sorted, i, k * (B + 1) + B + 1);
+	}
+	return i;
+}
+
+void STree::Build(const int* sorted, int size) {
+	delete[] raw;
+	delete[] rank;
+	n = size;
+	blocks = (n + B - 1) / B;
+	raw = new int[blocks * B + 16];
+	keys = AlignToCacheLine(raw);
+	rank = new int[blocks * B];
+	Fill(sorted, 0, 0);
+}
+
+int STree::RankInNode(int k, int key) {
+	const int* node = keys + k * B;
+#if SEARCH_SIMD
+	__m128i x = _mm_set1_epi32(key);
+	__m128i sum = _mm_cmpgt_epi32(x, _mm_load_si128((const __m128i*)node));		//Each lane is -1 where node key < key
+	sum = _mm_add_epi32(sum, _mm_cmpgt_epi32(x, _mm_load_si128((const __m128i*)(node + 4))));
+	sum = _mm_add_epi32(sum, _mm_cmpgt_epi32(x, _mm_load_si128((const __m128i*)(node + 8))));
+	sum = _mm_add_epi32(sum, _mm_cmpgt_epi32(x, _mm_load_si128((const __m128i*)(node + 12))));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));					//Horizontal add of the 4 lanes
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+	return -_mm_cvtsi128_si32(sum);
+#else
+	int count = 0;
+	for (int j = 0; j < B; j++) count += (node[j] < key);
+	return count;
+#endif
+}
+
+int STree::LowerBound(int key) {
+	int result = n;
+	int k = 0;
+	while (k < blocks) {
+		int j = RankInNode(k, key);						//j keys of this node are smaller, so key j is the best candidate here
+		if (j < B) result = rank[k * B + j];			//Deeper candidates are always smaller, so they replace this one
+		k = k * (B + 1) + j + 1;
+	}
+	return result;
+}
+
+int STree::Search(int key) {
+	int result = -1;
+	int k = 0;
+	while (k < blocks) {
+		int j = RankInNode(k, key);
+		if (j < B && keys[k * B + j] == key && rank[k * B + j] < n) result = rank[k * B + j];
+		k = k * (B + 1) + j + 1;
+	}
+	return result;
+}
 
 
 //
@@ -153,6 +766,817 @@ Node* MSort(Node* list1, int size) {
 }
 
 
+
+//
+// Run Struct: Describes one already sorted stretch of a list
+// [Used by the natural merge sort below to keep track of pending runs]
+//
+struct Run {
+	Node* head;
+	Node* tail;
+	int len;
+};
+
+//
+// Computes the minimum run length for a list of n nodes (same rule as TimSort):
+// Keeps the number of runs close to a power of 2 so the final merges stay balanced
+//
+int MinRunLength(int n) {
+	int r = 0;
+	while (n >= 64) {
+		r |= n & 1;
+		n >>= 1;
+	}
+	return n + r;
+}
+
+//
+// Detaches the next run from the front of "rest" and returns it:
+//
+// An ascending (non-decreasing) run is taken as is, a strictly descending run
+// is reversed in place [strict so that equal keys keep their order]
+// Runs shorter than minRun are extended with insertion so random input
+// does not produce thousands of tiny runs
+//
+Run NextRun(Node*& rest, int minRun) {
+	Run r;
+	r.head = rest;
+	r.tail = rest;
+	r.len = 1;
+	rest = rest->Get_Pnext();
+
+	if (rest != NULL && rest->Get_SID() < r.head->Get_SID()) {
+		while (rest != NULL && rest->Get_SID() < r.head->Get_SID()) {
+			Node* next = rest->Get_Pnext();
+			rest->Set_Pnext(r.head);						//Descending Run: Push each node onto the front, which reverses the run
+			r.head = rest;
+			rest = next;
+			r.len++;
+		}
+	}
+	else {
+		while (rest != NULL && rest->Get_SID() >= r.tail->Get_SID()) {
+			r.tail = rest;									//Ascending Run: Nodes are already linked, just move the tail forward
+			rest = rest->Get_Pnext();
+			r.len++;
+		}
+	}
+	r.tail->Set_Pnext(NULL);								//Disconnect the run from the rest of the list
+
+	while (r.len < minRun && rest != NULL) {
+		Node* x = rest;
+		rest = rest->Get_Pnext();
+		if (x->Get_SID() >= r.tail->Get_SID()) {
+			r.tail->Set_Pnext(x);							//Short Run: Insert the following nodes one by one, checking the tail
+			r.tail = x;										//and head first so nearly sorted data skips the scan
+			x->Set_Pnext(NULL);
+		}
+		else if (x->Get_SID() < r.head->Get_SID()) {
+			x->Set_Pnext(r.head);
+			r.head = x;
+		}
+		else {
+			Node* p = r.head;
+			while (p->Get_Pnext()->Get_SID() <= x->Get_SID()) p = p->Get_Pnext();
+			x->Set_Pnext(p->Get_Pnext());
+			p->Set_Pnext(x);
+		}
+		r.len++;
+	}
+	return r;
+}
+
+//
+// Stable merge of two neighbouring runs ["a" comes before "b" in the input]
+//
+// If the runs are already in order they are simply joined [O(1)], otherwise
+// the merge "gallops": instead of relinking one node per comparison, it walks
+// the whole stretch of the winning run that belongs before the other head
+// and links that stretch in with a single pointer change
+//
+Run MergeRuns(Run a, Run b) {
+	Run result;
+	result.len = a.len + b.len;
+
+	if (a.tail->Get_SID() <= b.head->Get_SID()) {
+		a.tail->Set_Pnext(b.head);							//Case 1: Every key of a is <= every key of b, join a then b
+		result.head = a.head;
+		result.tail = b.tail;
+		return result;
+	}
+	if (b.tail->Get_SID() < a.head->Get_SID()) {
+		b.tail->Set_Pnext(a.head);							//Case 2: Every key of b is < every key of a, join b then a
+		result.head = b.head;
+		result.tail = a.tail;
+		return result;
+	}
+
+	Node dummy;												//Case 3: Interleaved runs, merge stretch by stretch
+	Node* last = &dummy;
+	Node* x = a.head;
+	Node* y = b.head;
+	while (x != NULL && y != NULL) {
+		if (x->Get_SID() <= y->Get_SID()) {
+			Node* end = x;
+			while (end->Get_Pnext() != NULL && end->Get_Pnext()->Get_SID() <= y->Get_SID()) end = end->Get_Pnext();
+			last->Set_Pnext(x);								//Ties go to a to keep the merge stable
+			last = end;
+			x = end->Get_Pnext();
+		}
+		else {
+			Node* end = y;
+			while (end->Get_Pnext() != NULL && end->Get_Pnext()->Get_SID() < x->Get_SID()) end = end->Get_Pnext();
+			last->Set_Pnext(y);
+			last = end;
+			y = end->Get_Pnext();
+		}
+	}
+	if (x != NULL) {
+		last->Set_Pnext(x);									//Whichever run is left over keeps its own tail
+		result.tail = a.tail;
+	}
+	else {
+		last->Set_Pnext(y);
+		result.tail = b.tail;
+	}
+	result.head = dummy.Get_Pnext();
+	return result;
+}
+
+//
+// Adaptive natural merge sort function:
+//
+// The function takes a list as input, and outputs address of the
+// head node of the sorted list [Stable, no size parameter needed]
+//
+// Unlike MSort, which always splits down to single nodes, this sort
+// finds the runs that are already sorted in the input and only merges
+// those, following TimSort's rules for when to merge pending runs
+//
+// A sorted or reversed list takes a single pass, and a mostly sorted list
+// with a few out of order elements takes close to linear time
+//
+Node* NaturalMSort(Node* list) {
+	if (list == NULL) return NULL;
+
+	int n = 0;
+	for (Node* p = list; p != NULL; p = p->Get_Pnext()) n++;
+	int minRun = MinRunLength(n);
+
+	Run stack[85];											//Pending runs: The merge rules keep run lengths growing at least like
+	int count = 0;											//Fibonacci numbers, so 85 entries covers any list an int can count
+	Node* rest = list;
+	while (rest != NULL) {
+		stack[count++] = NextRun(rest, minRun);
+
+		while (count > 1) {									//Merge pending runs until the TimSort invariants hold again:
+			int i = count - 2;								//len[i-1] > len[i] + len[i+1] and len[i] > len[i+1]
+			if ((i > 0 && stack[i - 1].len <= stack[i].len + stack[i + 1].len) ||
+				(i > 1 && stack[i - 2].len <= stack[i - 1].len + stack[i].len)) {
+				if (stack[i - 1].len < stack[i + 1].len) i--;
+			}
+			else if (stack[i].len > stack[i + 1].len) {
+				break;
+			}
+			stack[i] = MergeRuns(stack[i], stack[i + 1]);
+			for (int j = i + 1; j < count - 1; j++) stack[j] = stack[j + 1];
+			count--;
+		}
+	}
+
+	while (count > 1) {										//Input is used up: Merge whatever is left from the top down
+		stack[count - 2] = MergeRuns(stack[count - 2], stack[count - 1]);
+		count--;
+	}
+	return stack[0].head;
+}
+
+
+
+//
+// LSD radix sort:
+//
+// MSort compares keys, so it needs O(n log n) comparisons. SIDs are 32-bit
+// integers, so they can instead be sorted digit by digit [least significant
+// digit first] with a fixed number of linear passes
+//
+// Each pass counts how many keys have each digit value [histogram], turns the
+// counts into starting positions, and scatters the keys to those positions.
+// All histograms are built in one read of the input, and a pass where every
+// key has the same digit [common for small or dense keys] is skipped
+//
+// digitBits is the digit size: 8 gives 4 passes with 256 buckets, 11 gives
+// 3 passes with 2048 buckets [fewer passes, bigger histograms]
+//
+
+//
+// Maps a signed key to an unsigned one with the same order
+// [flips the sign bit so negative keys come first]
+//
+unsigned RadixKey(int x) {
+	return (unsigned)x ^ 0x80000000u;
+}
+
+//
+// Runs work(0) ... work(threads - 1), each on its own thread
+// [work(0) runs on the calling thread]
+//
+template <class Work>
+void RunParallel(int threads, Work work) {
+	thread* workers = new thread[threads];
+	for (int t = 1; t < threads; t++) workers[t] = thread(work, t);
+	work(0);
+	for (int t = 1; t < threads; t++) workers[t].join();
+	delete[] workers;
+}
+
+//
+// Radix sorts an int array of size n in place [stable]
+//
+// With threads > 1 the array is split into one chunk per thread: each
+// thread builds the histogram of its chunk, and during a pass each thread
+// scatters its own chunk to positions computed from all of the histograms
+// [thread t writes after threads 0..t-1 in every bucket, so it stays stable]
+// Chunks hold different keys after a pass moves them, so the per-thread
+// histogram of later passes is rebuilt from the current chunk
+//
+void RadixSort(int* list, int n, int digitBits = 8, int threads = 1) {
+	if (n < 2) return;
+	if (digitBits < 1) digitBits = 1;
+	if (digitBits > 16) digitBits = 16;
+	if (threads < 1) threads = 1;
+	if (threads > n) threads = n;
+
+	int passes = (32 + digitBits - 1) / digitBits;
+	int radix = 1 << digitBits;
+	unsigned mask = (unsigned)radix - 1;
+
+	int* counts = new int[threads * passes * radix]();		//counts[(t * passes + p) * radix + digit]
+	int* offsets = new int[threads * radix];
+	int* buffer = new int[n];
+
+	RunParallel(threads, [&](int t) {
+		int begin = (int)((long long)n * t / threads);
+		int end = (int)((long long)n * (t + 1) / threads);
+		int* local = counts + t * passes * radix;
+		for (int i = begin; i < end; i++) {
+			unsigned k = RadixKey(list[i]);
+			for (int p = 0; p < passes; p++) {
+				local[p * radix + ((k >> (p * digitBits)) & mask)]++;	//Histograms of every digit from a single read
+			}
+		}
+	});
+
+	int* src = list;
+	int* dst = buffer;
+	bool moved = false;
+	for (int p = 0; p < passes; p++) {
+		int shift = p * digitBits;
+
+		int first = (RadixKey(list[0]) >> shift) & mask;
+		int total = 0;
+		for (int t = 0; t < threads; t++) total += counts[(t * passes + p) * radix + first];
+		if (total == n) continue;							//Every key has the same digit as list[0], the pass would not move anything
+
+		if (moved && threads > 1) {
+			RunParallel(threads, [&](int t) {
+				int begin = (int)((long long)n * t / threads);
+				int end = (int)((long long)n * (t + 1) / threads);
+				int* local = counts + (t * passes + p) * radix;
+				for (int b = 0; b < radix; b++) local[b] = 0;
+				for (int i = begin; i < end; i++) local[(RadixKey(src[i]) >> shift) & mask]++;
+			});
+		}
+
+		int running = 0;
+		for (int b = 0; b < radix; b++) {
+			for (int t = 0; t < threads; t++) {
+				offsets[t * radix + b] = running;			//Thread t starts after all smaller digits and after threads 0..t-1
+				running += counts[(t * passes + p) * radix + b];
+			}
+		}
+
+		RunParallel(threads, [&](int t) {
+			int begin = (int)((long long)n * t / threads);
+			int end = (int)((long long)n * (t + 1) / threads);
+			int* offset = offsets + t * radix;
+			for (int i = begin; i < end; i++) {
+				dst[offset[(RadixKey(src[i]) >> shift) & mask]++] = src[i];
+			}
+		});
+
+		int* temp = src;									//Output of this pass is the input of the next
+		src = dst;
+		dst = temp;
+		moved = true;
+	}
+
+	if (src != list) {
+		for (int i = 0; i < n; i++) list[i] = src[i];		//Odd number of passes done: copy the result back
+	}
+	delete[] counts;
+	delete[] offsets;
+	delete[] buffer;
+}
+
+//
+// Radix sort function for lists:
+//
+// The function takes a list as input, and outputs address of the
+// head node of the sorted list [stable, no nodes are moved in memory]
+//
+// Each pass appends every node to the tail of its digit's bucket list,
+// then joins the bucket lists together in digit order
+//
+Node* RadixSortList(Node* list, int digitBits = 8) {
+	if (list == NULL || list->Get_Pnext() == NULL) return list;
+	if (digitBits < 1) digitBits = 1;
+	if (digitBits > 16) digitBits = 16;
+
+	int passes = (32 + digitBits - 1) / digitBits;
+	int radix = 1 << digitBits;
+	unsigned mask = (unsigned)radix - 1;
+
+	int n = 0;
+	int* counts = new int[passes * radix]();
+	for (Node* node = list; node != NULL; node = node->Get_Pnext()) {
+		unsigned k = RadixKey(node->Get_SID());
+		for (int p = 0; p < passes; p++) counts[p * radix + ((k >> (p * digitBits)) & mask)]++;
+		n++;
+	}
+
+	Node** heads = new Node*[radix];
+	Node** tails = new Node*[radix];
+	for (int p = 0; p < passes; p++) {
+		int shift = p * digitBits;
+		int first = (RadixKey(list->Get_SID()) >> shift) & mask;
+		if (counts[p * radix + first] == n) continue;		//Every node has the same digit as the head, skip the pass
+
+		for (int b = 0; b < radix; b++) heads[b] = NULL;
+		Node* node = list;
+		while (node != NULL) {
+			int d = (RadixKey(node->Get_SID()) >> shift) & mask;
+			if (heads[d] == NULL) heads[d] = node;			//Scatter: Append node to the tail of its bucket
+			else tails[d]->Set_Pnext(node);
+			tails[d] = node;
+			node = node->Get_Pnext();
+		}
+
+		Node* last = NULL;
+		for (int b = 0; b < radix; b++) {
+			if (heads[b] == NULL) continue;
+			if (last == NULL) list = heads[b];				//Gather: Join non-empty buckets in digit order
+			else last->Set_Pnext(heads[b]);
+			last = tails[b];
+		}
+		last->Set_Pnext(NULL);
+	}
+
+	delete[] counts;
+	delete[] heads;
+	delete[] tails;
+	return list;
+}
+
+
+//
+// External merge sort:
+//
+// MSort and RadixSort need the whole list in memory. ExternalSort sorts a
+// file of ints that can be much larger than memory in two phases:
+//
+// 1. Run generation: Read memory-sized chunks, sort each one in memory with
+//    RadixSort [optionally multithreaded], and write it to a temp "run" file
+// 2. Merging: Merge up to fanIn runs at a time with a loser tree into a new,
+//    longer run, until a final merge writes the output file
+//
+// All file access goes through large sequential buffers [IntReader/IntWriter]
+//
+
+//
+// IntReader Class: Buffered reader for a stream of ints, either raw binary
+// [4 bytes per int] or text [ints separated by whitespace]
+//
+class IntReader {
+private:
+	ifstream file;
+	bool text;
+	char* buffer;
+	long long capacity;
+	long long pos;
+	long long len;
+
+	// Moves unread bytes to the front of the buffer and reads more after them
+	// Returns false if no new bytes could be read
+	bool Refill();
+
+public:
+	//
+	// Opens path for reading with a buffer of bufferBytes
+	// Returns false if the file can't be opened
+	//
+	bool Open(const char* path, bool isText, long long bufferBytes);
+
+	//
+	// Reads the next int into x, returns false at the end of the stream
+	//
+	bool Next(int& x);
+
+	void Close();
+
+	IntReader();
+	~IntReader();
+};
+
+IntReader::IntReader() {
+	text = false;
+	buffer = NULL;
+	capacity = 0;
+	pos = 0;
+	len = 0;
+}
+
+IntReader::~IntReader() {
+	Close();
+}
+
+bool IntReader::Open(const char* path, bool isText, long long bufferBytes) {
+	Close();
+	file.open(path, ios::in | ios::binary);
+	if (!file.is_open()) return false;
+	text = isText;
+	capacity = (bufferBytes < 4096) ? 4096 : bufferBytes;
+	buffer = new char[capacity];
+	pos = 0;
+	len = 0;
+	return true;
+}
+
+void IntReader::Close() {
+	if (file.is_open()) file.close();
+	delete[] buffer;
+	buffer = NULL;
+}
+
+bool IntReader::Refill() {
+	long long left = len - pos;
+	for (long long i = 0; i < left; i++) buffer[i] = buffer[pos + i];
+	pos = 0;
+	len = left;
+	if (!file) return false;
+	file.read(buffer + len, capacity - len);
+	len += file.gcount();
+	return len > left;
+}
+
+bool IntReader::Next(int& x) {
+	if (!text) {
+		if (len - pos < (long long)sizeof(int) && !Refill()) return false;
+		if (len - pos < (long long)sizeof(int)) return false;		//Trailing partial int is ignored
+		char* bytes = (char*)&x;
+		for (int i = 0; i < (int)sizeof(int); i++) bytes[i] = buffer[pos + i];
+		pos += sizeof(int);
+		return true;
+	}
+
+	while (true) {															//Text: Skip whitespace, then parse [-]digits
+		if (pos == len && !Refill()) return false;
+		char c = buffer[pos];
+		if (c == '-' || (c >= '0' && c <= '9')) break;
+		pos++;
+	}
+	bool negative = false;
+	if (buffer[pos] == '-') {
+		negative = true;
+		pos++;
+	}
+	long long value = 0;
+	while (true) {
+		if (pos == len && !Refill()) break;
+		char c = buffer[pos];
+		if (c < '0' || c > '9') break;
+		value = value * 10 + (c - '0');
+		pos++;
+	}
+	x = (int)(negative ? -value : value);
+	return true;
+}
+
+//
+// IntWriter Class: Buffered writer for a stream of ints, either raw binary
+// or text [one int per line]
+//
+class IntWriter {
+private:
+	ofstream file;
+	bool text;
+	char* buffer;
+	long long capacity;
+	long long len;
+
+	void Flush();
+
+public:
+	//
+	// Creates/overwrites path with a buffer of bufferBytes
+	// Returns false if the file can't be opened
+	//
+	bool Open(const char* path, bool isText, long long bufferBytes);
+
+	//
+	// Appends x to the stream
+	//
+	void Put(int x);
+
+	//
+	// Flushes and closes the file, returns false if any write failed
+	//
+	bool Close();
+
+	IntWriter();
+	~IntWriter();
+};
+
+IntWriter::IntWriter() {
+	text = false;
+	buffer = NULL;
+	capacity = 0;
+	len = 0;
+}
+
+IntWriter::~IntWriter() {
+	Close();
+}
+
+bool IntWriter::Open(const char* path, bool isText, long long bufferBytes) {
+	Close();
+	file.open(path, ios::out | ios::binary | ios::trunc);
+	if (!file.is_open()) return false;
+	text = isText;
+	capacity = (bufferBytes < 4096) ? 4096 : bufferBytes;
+	buffer = new char[capacity];
+	len = 0;
+	return true;
+}
+
+void IntWriter::Flush() {
+	file.write(buffer, len);
+	len = 0;
+}
+
+void IntWriter::Put(int x) {
+	if (len + 16 > capacity) Flush();						//16 bytes fits any int in text or binary form
+	if (!text) {
+		char* bytes = (char*)&x;
+		for (int i = 0; i < (int)sizeof(int); i++) buffer[len++] = bytes[i];
+		return;
+	}
+	char digits[12];
+	int count = 0;
+	long long value = x;
+	if (value < 0) {
+		buffer[len++] = '-';
+		value = -value;
+	}
+	do {
+		digits[count++] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value > 0);
+	while (count > 0) buffer[len++] = digits[--count];
+	buffer[len++] = '\n';
+}
+
+bool IntWriter::Close() {
+	if (!file.is_open()) return true;
+	Flush();
+	bool ok = !file.fail();
+	file.close();
+	delete[] buffer;
+	buffer = NULL;
+	return ok;
+}
+
+//
+// LoserTree Class: Picks the smallest head among k sorted streams in
+// log2(k) comparisons per output [used for the k-way merge]
+//
+// Internal node t stores the stream that LOST the match at t, and tree[0]
+// stores the overall winner. After the winner advances, only the matches
+// on its path to the root are replayed
+//
+class LoserTree {
+private:
+	int k;
+	int* tree;
+	long long* heads;		// Current head of each stream, LLONG_MAX once a stream is used up
+
+	// Replays the matches from stream s's leaf up to the root
+	void Adjust(int s);
+
+public:
+	//
+	// Builds the tree from the first key of each of the k streams
+	// [exhausted streams should be passed as LLONG_MAX]
+	//
+	void Build(const long long* first, int streams);
+
+	//
+	// Returns the stream holding the smallest head
+	//
+	int Winner();
+
+	//
+	// Returns the smallest head [LLONG_MAX once every stream is used up]
+	//
+	long long WinnerKey();
+
+	//
+	// Replaces the winner's head with its next key and finds the new winner
+	//
+	void Replace(long long next);
+
+	LoserTree();
+	~LoserTree();
+};
+
+LoserTree::LoserTree() {
+	k = 0;
+	tree = NULL;
+	heads = NULL;
+}
+
+LoserTree::~LoserTree() {
+	delete[] tree;
+	delete[] heads;
+}
+
+void LoserTree::Adjust(int s) {
+	for (int t = (s + k) / 2; t > 0; t /= 2) {
+		if (heads[s] > heads[tree[t]]) {					//s lost this match: it stays here, and the winner moves up
+			int temp = s;
+			s = tree[t];
+			tree[t] = temp;
+		}
+	}
+	tree[0] = s;
+}
+
+void LoserTree::Build(const long long* first, int streams) {
+	delete[] tree;
+	delete[] heads;
+	k = streams;
+	tree = new int[k];
+	heads = new long long[k + 1];
+	for (int i = 0; i < k; i++) heads[i] = first[i];
+	heads[k] = LLONG_MIN;									//Placeholder stream that wins every match until it is pushed out
+	for (int t = 0; t < k; t++) tree[t] = k;
+	for (int i = k - 1; i >= 0; i--) Adjust(i);
+}
+
+int LoserTree::Winner() {
+	return tree[0];
+}
+
+long long LoserTree::WinnerKey() {
+	return heads[tree[0]];
+}
+
+void LoserTree::Replace(long long next) {
+	heads[tree[0]] = next;
+	Adjust(tree[0]);
+}
+
+//
+// Builds the temp file name of run "id" for output file outPath
+//
+void RunFileName(char* name, int size, const char* outPath, int id) {
+	snprintf(name, size, "%s.run%d.tmp", outPath, id);
+}
+
+//
+// Merges run files [first, last) of outPath into "target" with a loser tree,
+// then deletes them. Memory is split evenly between the input and output buffers
+//
+bool MergeRunFiles(const char* outPath, int first, int last, const char* target, bool text, long long memoryBytes) {
+	int k = last - first;
+	long long bufferBytes = memoryBytes / (k + 1);
+	char name[1024];
+
+	IntReader* readers = new IntReader[k];
+	long long* heads = new long long[k];
+	bool ok = true;
+	for (int i = 0; i < k; i++) {
+		RunFileName(name, sizeof(name), outPath, first + i);
+		int x;
+		if (!readers[i].Open(name, false, bufferBytes)) ok = false;
+		heads[i] = (ok && readers[i].Next(x)) ? x : LLONG_MAX;
+	}
+
+	IntWriter writer;
+	if (ok && writer.Open(target, text, bufferBytes)) {
+		LoserTree tree;
+		tree.Build(heads, k);
+		while (tree.WinnerKey() != LLONG_MAX) {
+			writer.Put((int)tree.WinnerKey());				//Output the smallest head, then refill from the same run
+			int x;
+			tree.Replace(readers[tree.Winner()].Next(x) ? x : LLONG_MAX);
+		}
+		ok = writer.Close();
+	}
+	else {
+		ok = false;
+	}
+
+	delete[] readers;										//Readers close their files here, so the runs can be deleted
+	delete[] heads;
+	for (int i = 0; i < k; i++) {
+		RunFileName(name, sizeof(name), outPath, first + i);
+		remove(name);
+	}
+	return ok;
+}
+
+//
+// Sorts the ints in file inPath and writes them to outPath
+//
+// "text" selects whitespace separated text [true] or raw 4-byte binary ints
+// "memoryBytes" bounds the memory used for the chunks and the I/O buffers
+// [each I/O buffer is still at least 4096 bytes, so tiny budgets only make
+// the chunks, and so the runs, small]
+// "fanIn" is the largest number of runs merged at once [more runs are merged
+// in several passes]
+// "threads" is passed to RadixSort when sorting each chunk
+//
+// Temp runs are written next to the output as outPath.runN.tmp
+// Returns false if a file could not be opened or written
+//
+bool ExternalSort(const char* inPath, const char* outPath, bool text = false,
+	long long memoryBytes = 256LL << 20, int fanIn = 16, int threads = 1) {
+	if (fanIn < 2) fanIn = 2;
+	if (memoryBytes < 64) memoryBytes = 64;						//Room for a chunk of a few ints
+
+	long long ioBytes = memoryBytes / 8;
+	long long chunkInts = (memoryBytes - 2 * ioBytes) / (2 * (long long)sizeof(int));	//Radix sort needs a second buffer as big as the chunk
+	if (chunkInts > INT_MAX) chunkInts = INT_MAX;
+
+	IntReader in;
+	if (!in.Open(inPath, text, ioBytes)) return false;
+
+	int runs = 0;
+	char name[1024];
+	int* chunk = new int[chunkInts];
+	bool ok = true;
+	while (ok) {
+		int count = 0;
+		int x;
+		while (count < chunkInts && in.Next(x)) chunk[count++] = x;		//Phase 1: Fill one chunk, sort it, write it as a run
+		if (count == 0) break;
+		RadixSort(chunk, count, 11, threads);
+
+		IntWriter run;
+		RunFileName(name, sizeof(name), outPath, runs++);
+		if (!run.Open(name, false, ioBytes)) {
+			ok = false;
+			break;
+		}
+		for (int i = 0; i < count; i++) run.Put(chunk[i]);
+		ok = run.Close();
+	}
+	delete[] chunk;
+	in.Close();
+
+	if (!ok) {
+		for (int i = 0; i < runs; i++) {
+			RunFileName(name, sizeof(name), outPath, i);
+			remove(name);
+		}
+		return false;
+	}
+
+	if (runs == 0) {
+		IntWriter empty;											//Empty input: still create an empty output file
+		return empty.Open(outPath, text, 4096) && empty.Close();
+	}
+
+	int first = 0;
+	int next = runs;
+	while (ok && next - first > fanIn) {						//Phase 2: Merge fanIn runs at a time into new runs
+		int last = first + fanIn;								//[new runs get the next ids, so the oldest runs merge first]
+		RunFileName(name, sizeof(name), outPath, next);
+		ok = MergeRunFiles(outPath, first, last, name, false, memoryBytes);
+		first = last;
+		next++;
+	}
+	if (!ok) {
+		for (int i = first; i < next; i++) {
+			RunFileName(name, sizeof(name), outPath, i);
+			remove(name);
+		}
+		return false;
+	}
+	return MergeRunFiles(outPath, first, next, outPath, text, memoryBytes);	//Final merge writes the output format
+}
+
 int main()
 {
 	// This array holds the list for binary search
@@ -166,7 +1590,11 @@ int main()
 	//Key = Search key for binary search
 	int mode, temp, key; 
 
+	// Digit width and thread count for RadixSort() [mode 10 only]
+	int digitBits = 8, threads = 1;
+
 	cin >> mode >> key;
+	if (mode == 10) cin >> digitBits >> threads;	//Read before the list so they are not taken as list values
 
 	// Takes input for binary search
 	// For simplicity, we assume there are always 11 input integers that are 
@@ -194,7 +1622,9 @@ int main()
 
 	// Mode 0: test BSearch()
 	if (mode == 0) {
-		cout << BSearch(L1, 0, 10, key);			//Parameters: L1 is whole list, 0 is first element, 10 is last element, key is key
+		PrintTrace trace;
+		cout << BSearch(L1, 0, 10, key, trace);	//Parameters: L1 is whole list, 0 is first element, 10 is last element, key is key
+												//PrintTrace prints every probed value before the result
 	}
 
 	// Mode 1: test MSort()
@@ -213,7 +1643,111 @@ int main()
 			temp = temp->Get_Pnext();
 		}
 	}
-	
+
+	// Mode 3: test BranchlessLowerBound()
+	else if (mode == 3) {
+		int i = BranchlessLowerBound(L1, 11, key);
+		cout << ((i < 11 && L1[i] == key) ? i : -1);
+	}
+
+	// Mode 4: test EytzingerArray
+	else if (mode == 4) {
+		EytzingerArray e;
+		e.Build(L1, 11);
+		cout << e.Search(key);
+	}
+
+	// Mode 5: test STree
+	else if (mode == 5) {
+		STree t;
+		t.Build(L1, 11);
+		cout << t.Search(key);
+	}
+
+	// Mode 6: test BSearchBatch() and EytzingerArray::SearchBatch()
+	// Searches every list element and then the key in one batch
+	else if (mode == 6) {
+		int keys[12], out[12];
+		for (int i = 0; i < 11; i++) keys[i] = L1[i];
+		keys[11] = key;
+		BSearchBatch(L1, 11, keys, 12, out);
+		for (int i = 0; i < 12; i++) cout << out[i];
+		cout << '\n';
+		EytzingerArray e;
+		e.Build(L1, 11);
+		e.SearchBatch(keys, 12, out);
+		for (int i = 0; i < 12; i++) cout << out[i];
+	}
+
+	// Mode 7: test BSearch() with CountTrace [prints result, probes, max depth]
+	else if (mode == 7) {
+		CountTrace trace;
+		int result = BSearch(L1, 0, 10, key, trace);
+		cout << result << ' ' << trace.Get_Probes() << ' ' << trace.Get_MaxDepth();
+	}
+
+	// Mode 8: test RadixSortList()
+	else if (mode == 8) {
+		L2 = RadixSortList(L2);
+		Node* temp = L2;
+		while (temp != NULL) {
+			cout << temp->Get_SID();
+			temp = temp->Get_Pnext();
+		}
+	}
+
+	// Mode 9: test GallopSearch() [hint = middle of list] and InterpolationSearch()
+	else if (mode == 9) {
+		cout << GallopSearch(L1, 11, key, 5) << ' ' << InterpolationSearch(L1, 11, key);
+	}
+
+	// Mode 2: test NaturalMSort()
+	else if (mode == 2) {
+		L2 = NaturalMSort(L2);					//No size needed: Runs are found while sorting
+		Node* temp = L2;
+		while (temp != NULL) {
+			cout << temp->Get_SID();
+			temp = temp->Get_Pnext();
+		}
+	}
+
+	// Mode 10: test RadixSort() on an array [digitBits and threads follow the key]
+	else if (mode == 10) {
+		int size = 0;
+		for (Node* p = L2; p != NULL; p = p->Get_Pnext()) size++;
+		int* list = new int[size];
+		int i = 0;
+		for (Node* p = L2; p != NULL; p = p->Get_Pnext()) list[i++] = p->Get_SID();
+		RadixSort(list, size, digitBits, threads);
+		for (i = 0; i < size; i++) cout << list[i];
+		delete[] list;
+	}
+
+	// Mode 11: test ExternalSort() [64 byte budget and fan-in 2, so the list
+	// is sorted as many short runs merged in several passes]
+	else if (mode == 11) {
+		ofstream input("external.input");
+		for (Node* p = L2; p != NULL; p = p->Get_Pnext()) input << p->Get_SID() << '\n';
+		input.close();
+		if (ExternalSort("external.input", "external.output", true, 64, 2)) {
+			ifstream output("external.output");
+			while (output >> temp) cout << temp;
+		}
+		remove("external.input");
+		remove("external.output");
+	}
+
+	// Mode 12: test SortedSearch with each strategy [binary, gallop, interpolation]
+	else if (mode == 12) {
+		SortedSearch search;
+		search.Attach(L1, 11, SEARCH_BINARY);
+		cout << search.Search(key) << ' ';
+		search.Attach(L1, 11, SEARCH_GALLOP);
+		cout << search.Search(key) << ' ';
+		search.Attach(L1, 11, SEARCH_INTERPOLATION);
+		cout << search.Search(key);
+	}
+
 	return 0;
 }
 
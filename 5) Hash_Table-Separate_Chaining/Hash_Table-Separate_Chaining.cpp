@@ -4,204 +4,2056 @@
 // The chains should are implemented using singly linked list. 
 // 
 #include <iostream>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HASH_SIMD 1
+#define PREFETCH(p) _mm_prefetch((const char*)(p), _MM_HINT_T0)
+#else
+#define HASH_SIMD 0
+#define PREFETCH(p) ((void)0)
+#endif
 using namespace std;
 
 //
 // Basic Node Class used to construct Lists in Hash Table
 // [Contains pointer for next Node in list]
 //
-class Node {
+// K is the key type and V the satellite data stored with it. The key and
+// p_next come first, so walking a chain only touches the start of each
+// Node even when V is large
+//
+template <class K, class V>
+class ChainNode {
+private:
+	K key;
+	ChainNode* p_next;
+	V value;
+
+public:
+	void Set_key(const K& x);
+	const K& Get_key();
+	void Set_value(const V& x);
+	V& Get_value();
+	void Set_p(ChainNode* p);
+	ChainNode* Get_p();
+	ChainNode();
+
+	// Constructs the value in place from args
+	template <class... Args>
+	ChainNode(const K& k, Args&&... args);
+};
+
+template <class K, class V>
+ChainNode<K, V>::ChainNode() : key(), p_next(NULL), value() {
+}
+
+template <class K, class V>
+template <class... Args>
+ChainNode<K, V>::ChainNode(const K& k, Args&&... args) : key(k), p_next(NULL), value(std::forward<Args>(args)...) {
+}
+
+template <class K, class V>
+void ChainNode<K, V>::Set_key(const K& x) {
+	key = x;
+}
+
+template <class K, class V>
+const K& ChainNode<K, V>::Get_key() {
+	return key;
+}
+
+template <class K, class V>
+void ChainNode<K, V>::Set_value(const V& x) {
+	value = x;
+}
+
+template <class K, class V>
+V& ChainNode<K, V>::Get_value() {
+	return value;
+}
+
+template <class K, class V>
+void ChainNode<K, V>::Set_p(ChainNode* p) {
+	p_next = p;
+}
+
+template <class K, class V>
+ChainNode<K, V>* ChainNode<K, V>::Get_p() {
+	return p_next;
+}
+
+// Value type of tables that only store keys
+struct NoValue {
+};
+
+// Node of a student table: SID only
+typedef ChainNode<int, NoValue> Node;
+
+//
+// Hash policies: HashTable is a template over one of these classes. Each
+// one has a static Hash(key) that turns a key into a 32-bit value, and the
+// table reduces that value to a bucket with a mask when its size is a
+// power of two, or with modulo for any other size
+//
+// IdentityHash: The key itself [default, gives the original key % size,
+//               good for keys that are already random]
+// FibonacciHash: Multiplies by 2^64 / golden ratio and keeps the high bits,
+//                so clustered or strided keys spread over the whole table
+//                [bit-reversed, so a power-of-two table's mask takes the top
+//                log2(size) bits of the product, as Knuth's method does]
+// MurmurHash: Murmur3's 32-bit finalizer, every key bit changes about half
+//             of the hash bits
+// StringHash: FNV-1a over the characters, for string keys [also hashes
+//             const char*, so a HashMap<string, ...> can be searched with a
+//             literal without building a string]
+//
+// All of them hash through unsigned, so negative keys still give a valid bucket
+//
+class IdentityHash {
+public:
+	static unsigned Hash(int key) {
+		return (unsigned)key;
+	}
+};
+
+class FibonacciHash {
+public:
+	static unsigned Hash(int key) {
+		unsigned h = (unsigned)(((unsigned long long)(unsigned)key * 11400714819323198485ull) >> 32);
+		h = ((h >> 1) & 0x55555555u) | ((h & 0x55555555u) << 1);	//Reverse the bits, so the low bits Reduce
+		h = ((h >> 2) & 0x33333333u) | ((h & 0x33333333u) << 2);	//masks are the top bits of the product
+		h = ((h >> 4) & 0x0F0F0F0Fu) | ((h & 0x0F0F0F0Fu) << 4);
+		h = ((h >> 8) & 0x00FF00FFu) | ((h & 0x00FF00FFu) << 8);
+		return (h >> 16) | (h << 16);
+	}
+};
+
+class MurmurHash {
+public:
+	static unsigned Hash(int key) {
+		unsigned h = (unsigned)key;
+		h ^= h >> 16;
+		h *= 0x85ebca6bu;
+		h ^= h >> 13;
+		h *= 0xc2b2ae35u;
+		h ^= h >> 16;
+		return h;
+	}
+};
+
+class StringHash {
+public:
+	static unsigned Hash(const char* key, size_t n) {
+		unsigned h = 2166136261u;
+		for (size_t i = 0; i < n; i++) {
+			h ^= (unsigned char)key[i];
+			h *= 16777619u;
+		}
+		return h;
+	}
+
+	static unsigned Hash(const string& key) {
+		return Hash(key.data(), key.size());
+	}
+
+	static unsigned Hash(const char* key) {
+		return Hash(key, strlen(key));
+	}
+};
+
+//
+// Equality policy: Equal(a, b) is a == b, where b may be of a different
+// type than the table's keys [e.g. a const char* searched in a table of
+// strings]. Any type comparable with == works
+//
+class DefaultEqual {
+public:
+	template <class A, class B>
+	static bool Equal(const A& a, const B& b) {
+		return a == b;
+	}
+};
+
+//
+// Reduces hash value h to a bucket of a table with tableSize buckets
+// [a mask for power of two sizes, modulo otherwise]
+//
+unsigned Reduce(unsigned h, unsigned tableSize) {
+	if ((tableSize & (tableSize - 1)) == 0) return h & (tableSize - 1);
+	return h % tableSize;
+}
+
+//
+// Returns the smallest power of two that is >= x
+//
+unsigned NextPowerOfTwo(unsigned x) {
+	unsigned p = 1;
+	while (p < x) p <<= 1;
+	return p;
+}
+
+//
+// NodePool Class: Slab allocator for the Nodes [any T] of a HashTable
+//
+// Nodes are handed out from blocks of POOL_BLOCK_SIZE Nodes instead of one
+// "new" each, and freed Nodes go on a free list [linked through the freed
+// memory] to be reused by the next Allocate. Nodes added one after another
+// come from the same block, so they end up close together in memory
+//
+// Blocks are raw memory: Allocate constructs a Node in place and Free
+// destroys it. Nodes still allocated when the pool is destroyed are not
+// destroyed [the owner does that]
+//
+const int POOL_BLOCK_SIZE = 1024;
+
+template <class T>
+class NodePool {
+private:
+	// A freed slot, reused to link the free list
+	struct FreeSlot {
+		FreeSlot* next;
+	};
+	static_assert(sizeof(T) >= sizeof(FreeSlot), "pooled type must hold a pointer");
+
+	// Allocated blocks [each room for POOL_BLOCK_SIZE Nodes]
+	T** blocks;
+	int blockCount;
+	int blockCapacity;
+
+	// Nodes of the newest block that have been handed out
+	int used;
+
+	// Freed Nodes waiting to be reused
+	FreeSlot* freeList;
+
+	// Allocates a new block
+	void NewBlock();
+
+public:
+	//
+	// Returns a Node constructed from args in an unused slot
+	//
+	template <class... Args>
+	T* Allocate(Args&&... args);
+
+	//
+	// Destroys Node p and returns it to the pool
+	//
+	void Free(T* p);
+
+	NodePool();
+	~NodePool();
+};
+
+template <class T>
+NodePool<T>::NodePool() {
+	blocks = NULL;
+	blockCount = 0;
+	blockCapacity = 0;
+	used = 0;
+	freeList = NULL;
+}
+
+template <class T>
+NodePool<T>::~NodePool() {
+	for (int i = 0; i < blockCount; i++) {
+		::operator delete(blocks[i]);
+	}
+	delete[] blocks;
+}
+
+template <class T>
+void NodePool<T>::NewBlock() {
+	if (blockCount == blockCapacity) {
+		blockCapacity = (blockCapacity == 0) ? 8 : blockCapacity * 2;		//Grow the list of blocks like a Vector
+		T** temp = new T*[blockCapacity];
+		for (int i = 0; i < blockCount; i++) temp[i] = blocks[i];
+		delete[] blocks;
+		blocks = temp;
+	}
+	blocks[blockCount++] = (T*)::operator new(sizeof(T) * POOL_BLOCK_SIZE);	//Uninitialized, Nodes are built by Allocate
+	used = 0;
+}
+
+template <class T>
+template <class... Args>
+T* NodePool<T>::Allocate(Args&&... args) {
+	void* slot;
+	if (freeList != NULL) {
+		slot = freeList;									//Reuse the most recently freed Node first [still in cache]
+		freeList = freeList->next;
+	}
+	else {
+		if (blockCount == 0 || used == POOL_BLOCK_SIZE) NewBlock();
+		slot = &blocks[blockCount - 1][used++];				//Otherwise take the next Node of the newest block
+	}
+	return new (slot) T(std::forward<Args>(args)...);
+}
+
+template <class T>
+void NodePool<T>::Free(T* p) {
+	p->~T();
+	FreeSlot* slot = new (p) FreeSlot;
+	slot->next = freeList;
+	freeList = slot;
+}
+
+//
+// Statistics: HashTable counts searches and probes as it runs, and
+// GetStats() adds a scan of the chains. The counters are a few additions
+// per Search, and building with HASH_STATS defined as 0 removes them
+//
+#ifndef HASH_STATS
+#define HASH_STATS 1
+#endif
+#if HASH_STATS
+#define STATS(x) x
+#else
+#define STATS(x)
+#endif
+
+// Chain lengths 0 .. STATS_HISTOGRAM_SIZE - 2 get their own histogram
+// entry, longer chains all go in the last one
+const int STATS_HISTOGRAM_SIZE = 16;
+
+struct TableStats {
+	int count;							// Students stored
+	int size;							// Buckets
+	double loadFactor;					// count / size
+	int maxChain;						// Longest chain
+	int histogram[STATS_HISTOGRAM_SIZE];	// Number of buckets with each chain length
+	long long hits;						// Successful searches
+	long long misses;					// Unsuccessful searches
+	double avgProbesHit;				// Nodes compared per successful search
+	double avgProbesMiss;				// Nodes compared per unsuccessful search
+	int rehashes;						// Resizes started
+};
+
+// 
+// The HashTable class implements a hash table whose elements 
+// are pointers -> Each pointer points to a linked 
+// list that holds the student(s) at that key
+// 
+// The table keeps track of how many students it holds: When the load
+// factor (students / size) goes above maxLoad, the table doubles its size,
+// and when it drops below minLoad, the table halves its size [never below
+// the size it was created with]. Nodes are relinked into the new table,
+// not copied, so average chain length stays bounded
+// 
+// The table owns its Nodes: they come from an internal NodePool and go
+// back to it when removed
+// 
+// Resizing is incremental [like Redis' dict]: the old and new tables are
+// kept side by side, and every Add/Search/Remove moves a few buckets from
+// the old table to the new one. Until every bucket is moved, lookups check
+// both tables. No single operation has to move the whole table
+// 
+// "Hash" is one of the hash policies above. Tables that grow are resized
+// to powers of two, so their bucket index is a mask instead of a division
+// 
+// HashMap is the general table: keys of type K, each stored with a value
+// of type V in its chain Node, compared with the "Equal" policy. HashTable
+// [below] is the student table, a HashMap of int keys with no value
+// 
+template <class K, class V, class Hash = IdentityHash, class Equal = DefaultEqual>
+class HashMap {
+
+public:
+
+	// Chain Node type of this table
+	typedef ChainNode<K, V> Entry;
+
+private:
+
+	// Size of the hash table. 
+	int size;
+
+	// Number of students stored in the table
+	int count;
+
+	// Size given to CreateTable [table never shrinks below this]
+	int minSize;
+
+	// Load factor limits that trigger a resize
+	double minLoad;
+	double maxLoad;
+	
+	// Basic Hash Function [for a table with tableSize buckets]
+	template <class Key>
+	int hash(const Key& key, int tableSize);
+
+	// Pointer to Table
+	// Pointer of Pointer: Points to Array of Pointers
+	Entry** table;
+
+	// Table being emptied into "table" during a resize [NULL otherwise]
+	Entry** oldTable;
+	int oldSize;
+
+	// Buckets of oldTable below rehashIdx have already been moved
+	int rehashIdx;
+
+	// Allocator for every Node in the table
+	NodePool<Entry> pool;
+
+	// Search/resize counters [see TableStats]
+	long long statHits;
+	long long statMisses;
+	long long statHitProbes;
+	long long statMissProbes;
+	int statRehashes;
+
+	// Adds one search that compared "probes" Nodes to the counters, returns result
+	Entry* RecordSearch(Entry* result, int probes);
+
+	// Adds the length of every chain starting at heads[0 .. n-1] to stats
+	void AddChains(TableStats& stats, Entry** heads, int first, int n);
+
+	// Starts moving every node into a new table of newSize buckets
+	void Rehash(int newSize);
+
+	// Moves the next non-empty bucket of oldTable [checking at most
+	// REHASH_EMPTY_VISITS empty buckets], finishing the resize at the end
+	void RehashStep();
+
+	// Removes the first node with key from the chain at *head
+	// Returns true if a node was removed
+	bool RemoveFromChain(Entry** head, const K& key);
+
+	// Puts "temp" at the head of bucket hashVal of the current table and
+	// grows the table if needed, returns temp
+	Entry* Link(Entry* temp, int hashVal);
+
+	// Destroys every node of the chain at head [memory stays in the pool]
+	void DestroyChain(Entry* head);
+
+	// Returns every node to the pool and frees the tables [table is left empty]
+	void Clear();
+
+	// Updates count after a removal and shrinks the table if needed
+	void Shrink();
+
+	
+public:
+
+	//
+	// This function creates a hash table using dynamic memory allocation
+	// and initializes all cells to NULL.
+	// 
+	// Creates table whose size is equal to divisor due to the nature of the
+	// basic hash function [a power of two divisor lets hashing use a mask]
+	//
+	void CreateTable(int divisor);
+
+	//
+	// Searches for a student whose SID = key
+	// If a student is found, return Student Node, otherwise, return NULL
+	//
+	Entry* Search(const K& key);
+
+	//
+	// Same as Search, but key can be any type that "Hash" can hash and
+	// "Equal" can compare with K [no K is built to search]. Hash must give
+	// the same value for equal keys of either type
+	//
+	template <class Key>
+	Entry* Find(const Key& key);
+
+	//
+	// Searches for n students at once: out[i] gets the Node whose SID = keys[i],
+	// or NULL [same results as calling Search for each key]
+	// 
+	// Keys are handled in groups: every bucket of a group is prefetched,
+	// then every chain head, then the chains are walked one Node per key
+	// per round with the next Nodes prefetched, so the cache misses of
+	// different keys overlap instead of happening one after another
+	//
+	void SearchBatch(const K* keys, int n, Entry** out);
+
+	//
+	// Adds a student with SID = key to the hash table, using a Node from
+	// the table's pool, and returns that Node. The value is constructed in
+	// the Node from args [does not check if key is already in the table]
+	//
+	template <class... Args>
+	Entry* Emplace(const K& key, Args&&... args);
+
+	//
+	// Sets the value of key if it is in the table, otherwise adds it:
+	// The key is hashed once and its chain walked once, and a new Node goes
+	// into the bucket that walk found. Returns the Node holding key
+	//
+	Entry* Upsert(const K& key, const V& value);
+
+	//
+	// This function adds a student (address stored at "temp") to the hash table
+	// The student is copied into a pooled Node and "temp" is freed
+	// [use Emplace to avoid the extra allocation]
+	//
+	void Add(Entry* temp);
+
+	//
+	// This function removes a student whose SID = key from the table
+	// If the student is not in the table, it does nothing
+	//
+	void Remove(const K& key);
+
+	//
+	// Returns the table size [Held in private size variable]
+	//
+	int Get_Size();
+
+	//
+	// Returns the number of students stored in the table
+	//
+	int Get_Count();
+
+	//
+	// Returns the current load factor (students / table size)
+	//
+	double Get_LoadFactor();
+
+	//
+	// Returns true while a resize is still moving buckets
+	//
+	bool IsRehashing();
+
+	//
+	// Returns count, load factor, chain length histogram, longest chain,
+	// average probes per search and number of resizes
+	// [search and resize numbers are 0 if HASH_STATS is 0]
+	//
+	TableStats GetStats();
+
+	//
+	// Prints GetStats() in a readable form
+	//
+	void PrintStats();
+
+	//
+	// Writes the table to file "path" in a flattened form: bucket count,
+	// the length of every chain, then all keys [and values] in chain order
+	// K and V must be plain data [no pointers or strings]
+	// Returns false if the file can't be written
+	//
+	bool Save(const char* path);
+
+	//
+	// Replaces the table with the one saved at "path": Chains are rebuilt
+	// as saved, from one read of the file, with no hashing or resizing
+	// Returns false, leaving the table unchanged, if the file is missing,
+	// cut short, or was saved by a different kind of table
+	//
+	bool Load(const char* path);
+
+	//
+	// Sets the load factors that trigger shrinking and growing
+	// [defaults: 0.25 and 1.0 -> min should be below max / 2 so a
+	// resize doesn't immediately trigger the opposite resize]
+	//
+	void SetLoadFactors(double minLoadFactor, double maxLoadFactor);
+
+
+	//
+	// Constructor: Initialize table to NULL, size & count to 0,
+	// load factor limits to their defaults
+	//
+	HashMap();
+
+	//
+	// Destructor: Destroys every Node still in the table, frees the tables
+	// [the pool frees the Nodes' memory]
+	//
+	~HashMap();
+
+
+	// 
+	// Print all Nodes/Students in table from top to bottom
+	//
+	void PrintTable();
+};
+
+
+//
+// The student table: SID keys only [Node is its chain Node]
+//
+template <class Hash = IdentityHash>
+using HashTable = HashMap<int, NoValue, Hash>;
+
+
+// Most empty buckets a single RehashStep looks at
+const int REHASH_EMPTY_VISITS = 10;
+
+
+//Implementing hash function: Hash policy, then reduced to a bucket with a mask or modulo
+template <class K, class V, class Hash, class Equal>
+template <class Key>
+int HashMap<K, V, Hash, Equal>::hash(const Key& key, int tableSize) {
+	return (int)Reduce(Hash::Hash(key), (unsigned)tableSize);
+}
+
+
+//Implementing CreateTable Method
+template <class K, class V, class Hash, class Equal>
+void HashMap<K, V, Hash, Equal>::CreateTable(int divisor) {
+	size = divisor;						//Step 1: Setting size equal to divisor
+										//[Modulo divisor directly indicates table size]
+	minSize = divisor;
+	count = 0;
+	table = new Entry*[size];
+	for (int i = 0; i < size; i++) {	//Step 2: Initialize table using size, fill table values with NULL
+		table[i] = NULL;
+	}
+}
+
+
+//Implementing Rehash: Sets up a new table with newSize buckets, nodes are moved later by RehashStep
+template <class K, class V, class Hash, class Equal>
+void HashMap<K, V, Hash, Equal>::Rehash(int newSize) {
+	STATS(statRehashes++);
+	oldTable = table;
+	oldSize = size;
+	rehashIdx = 0;
+
+	size = newSize;						//New students go straight into the new table
+	table = new Entry*[size];
+	for (int i = 0; i < size; i++) {
+		table[i] = NULL;
+	}
+}
+
+
+//Implementing RehashStep: Moves one bucket of the old table into the new table
+template <class K, class V, class Hash, class Equal>
+void HashMap<K, V, Hash, Equal>::RehashStep() {
+	int emptyVisits = REHASH_EMPTY_VISITS;
+	while (rehashIdx < oldSize && oldTable[rehashIdx] == NULL) {
+		rehashIdx++;						//Skip empty buckets, but only a few so the step stays short
+		if (--emptyVisits == 0) return;
+	}
+
+	if (rehashIdx < oldSize) {
+		Entry* temp = oldTable[rehashIdx];
+		while (temp != NULL) {
+			Entry* next = temp->Get_p();		//Detach each node from its old chain and push it onto the
+			int hashVal = hash(temp->Get_key(), size);	//head of its new chain [no nodes are allocated or freed]
+			temp->Set_p(table[hashVal]);
+			table[hashVal] = temp;
+			temp = next;
+		}
+		oldTable[rehashIdx] = NULL;
+		rehashIdx++;
+	}
+
+	if (rehashIdx == oldSize) {
+		delete[] oldTable;					//Every bucket moved: resize is finished
+		oldTable = NULL;
+		oldSize = 0;
+	}
+}
+
+
+template <class K, class V, class Hash, class Equal>
+ChainNode<K, V>* HashMap<K, V, Hash, Equal>::Search(const K& key) {
+	return Find(key);
+}
+
+
+template <class K, class V, class Hash, class Equal>
+template <class Key>
+ChainNode<K, V>* HashMap<K, V, Hash, Equal>::Find(const Key& key) {
+	if (oldTable != NULL) RehashStep();
+
+	int probes = 0;
+	unsigned h = Hash::Hash(key);	//Hash once, reduced for each table searched
+	int hashVal = (int)Reduce(h, (unsigned)size);	//Call hash function to get search value
+	Entry* temp = table[hashVal];	//Initialize temp Node at head to traverse list
+
+	while (temp != NULL) {
+		STATS(probes++);
+		if (Equal::Equal(temp->Get_key(), key)) return RecordSearch(temp, probes);	//While temp is not NULL(end of list) test if key equals search key
+		temp = temp->Get_p();
+	}												//If key is found, return temp Node
+
+	if (oldTable != NULL) {
+		hashVal = (int)Reduce(h, (unsigned)oldSize);	//During a resize, the key may still be in a bucket that
+		if (hashVal >= rehashIdx) {					//has not been moved yet
+			temp = oldTable[hashVal];
+			while (temp != NULL) {
+				STATS(probes++);
+				if (Equal::Equal(temp->Get_key(), key)) return RecordSearch(temp, probes);
+				temp = temp->Get_p();
+			}
+		}
+	}
+	
+	return RecordSearch(NULL, probes);	//If the entire list is traversed and nothing found, return NULL
+}
+
+
+template <class K, class V, class Hash, class Equal>
+ChainNode<K, V>* HashMap<K, V, Hash, Equal>::RecordSearch(Entry* result, int probes) {
+	STATS(
+		if (result != NULL) {
+			statHits++;
+			statHitProbes += probes;
+		}
+		else {
+			statMisses++;
+			statMissProbes += probes;
+		}
+	)
+	(void)probes;						//Unused when HASH_STATS is 0
+	return result;
+}
+
+
+// Keys handled together by SearchBatch
+const int SEARCH_BATCH_GROUP = 16;
+
+
+//Implementing HashTable's "SearchBatch" Method
+template <class K, class V, class Hash, class Equal>
+void HashMap<K, V, Hash, Equal>::SearchBatch(const K* keys, int n, Entry** out) {
+	if (oldTable != NULL) {
+		for (int i = 0; i < n; i++) out[i] = Search(keys[i]);	//During a resize keys may be in either table, use plain Search
+		return;
+	}
+
+	int bucket[SEARCH_BATCH_GROUP];
+	Entry* cur[SEARCH_BATCH_GROUP];
+	STATS(int probes[SEARCH_BATCH_GROUP];)						//Nodes compared for each key, as in Find
+	for (int g = 0; g < n; g += SEARCH_BATCH_GROUP) {
+		int groupSize = (n - g < SEARCH_BATCH_GROUP) ? n - g : SEARCH_BATCH_GROUP;
+		const K* groupKeys = keys + g;
+
+		for (int i = 0; i < groupSize; i++) {
+			bucket[i] = hash(groupKeys[i], size);				//Stage 1: Hash every key, prefetch its bucket
+			PREFETCH(&table[bucket[i]]);
+		}
+		for (int i = 0; i < groupSize; i++) {
+			cur[i] = table[bucket[i]];							//Stage 2: Read every chain head, prefetch the first Node
+			if (cur[i] != NULL) PREFETCH(cur[i]);
+			out[g + i] = NULL;
+			STATS(probes[i] = 0);
+		}
+
+		int active = 1;
+		while (active > 0) {									//Stage 3: Advance every unresolved chain by one Node per round
+			active = 0;
+			for (int i = 0; i < groupSize; i++) {
+				if (cur[i] == NULL) continue;
+				STATS(probes[i]++);
+				if (Equal::Equal(cur[i]->Get_key(), groupKeys[i])) {
+					out[g + i] = cur[i];
+					cur[i] = NULL;
+					continue;
+				}
+				cur[i] = cur[i]->Get_p();						//End of chain [NULL] leaves out[i] as not found
+				if (cur[i] != NULL) {
+					PREFETCH(cur[i]);
+					active++;
+				}
+			}
+		}
+		STATS(
+			for (int i = 0; i < groupSize; i++) RecordSearch(out[g + i], probes[i]);
+		)
+	}
+}
+
+
+//Implementing HashTable's "Emplace" Method
+template <class K, class V, class Hash, class Equal>
+template <class... Args>
+ChainNode<K, V>* HashMap<K, V, Hash, Equal>::Emplace(const K& key, Args&&... args) {
+	if (oldTable != NULL) RehashStep();
+
+	Entry* temp = pool.Allocate(key, std::forward<Args>(args)...);
+	return Link(temp, hash(key, size));	//Hash the nodes value to find table insertion point
+}
+
+
+//Implementing HashTable's "Upsert" Method
+template <class K, class V, class Hash, class Equal>
+ChainNode<K, V>* HashMap<K, V, Hash, Equal>::Upsert(const K& key, const V& value) {
+	if (oldTable != NULL) RehashStep();
+
+	unsigned h = Hash::Hash(key);
+	int hashVal = (int)Reduce(h, (unsigned)size);
+	for (Entry* temp = table[hashVal]; temp != NULL; temp = temp->Get_p()) {
+		if (Equal::Equal(temp->Get_key(), key)) {		//Key found: overwrite its value in place
+			temp->Set_value(value);
+			return temp;
+		}
+	}
+
+	if (oldTable != NULL) {
+		int oldVal = (int)Reduce(h, (unsigned)oldSize);	//During a resize it may still be in an unmoved bucket
+		if (oldVal >= rehashIdx) {
+			for (Entry* temp = oldTable[oldVal]; temp != NULL; temp = temp->Get_p()) {
+				if (Equal::Equal(temp->Get_key(), key)) {
+					temp->Set_value(value);
+					return temp;
+				}
+			}
+		}
+	}
+
+	return Link(pool.Allocate(key, value), hashVal);	//Not found: add it to the bucket already hashed
+}
+
+
+//Implementing Link: Adds a new node to the current table
+template <class K, class V, class Hash, class Equal>
+ChainNode<K, V>* HashMap<K, V, Hash, Equal>::Link(Entry* temp, int hashVal) {
+	temp->Set_p(table[hashVal]);		//Collision: If point in table already has data,
+	table[hashVal] = temp;				//connect it to the temp node to form linked list w/ temp at head
+
+	count++;
+	if (oldTable == NULL && count > maxLoad * size) {
+		Rehash((int)NextPowerOfTwo(size * 2));	//Too many students per bucket: double the table [rounded to a power of two]
+	}									//[Not while a resize is running: each table operation moves one old
+										//bucket, so it ends within about oldSize operations, before the
+										//count can double again when maxLoad >= 1]
+	return temp;
+}
+
+
+//Implementing HashTable's "Add" Method
+template <class K, class V, class Hash, class Equal>
+void HashMap<K, V, Hash, Equal>::Add(Entry* temp) {
+	Emplace(temp->Get_key(), temp->Get_value());
+	delete temp;
+}
+
+
+//Implementing RemoveFromChain: Unlinks the first node with key in the chain at *head, returns it to the pool
+template <class K, class V, class Hash, class Equal>
+bool HashMap<K, V, Hash, Equal>::RemoveFromChain(Entry** head, const K& key) {
+	if (*head == NULL) return false;				//Edge Case 1: If that table value is empty, return without doing anything
+
+	if (Equal::Equal((*head)->Get_key(), key)) {				//Edge Case 2: If the head of the linked list at that table value is the
+		Entry* toDel = *head;						//Node we want to remove, move the table pointer to the next node and
+		*head = toDel->Get_p();						//free the memory
+		pool.Free(toDel);
+		return true;
+	}
+													//Main Logic
+
+	Entry* temp = *head;								//Initialize temp pointer to traverse list at hashed table value
+	while (temp->Get_p() != NULL) {
+		if (Equal::Equal(temp->Get_p()->Get_key(), key)) {		//Searching forward: If next node has the value we want to remove:
+			Entry* toDel = temp->Get_p();			//1. Connect current node to node on other side of value to be removed
+			temp->Set_p(toDel->Get_p());			//2. Free memory in removed node
+			pool.Free(toDel);
+			return true;							//Return: Once it is found, no need to look anymore
+		}
+		temp = temp->Get_p();
+	}
+	return false;
+}
+
+
+//Implementing HashTable's "Remove" Method
+template <class K, class V, class Hash, class Equal>
+void HashMap<K, V, Hash, Equal>::Remove(const K& key) {
+	if (oldTable != NULL) RehashStep();
+
+	bool removed = RemoveFromChain(&table[hash(key, size)], key);		//Check the new table first, then the
+	if (!removed && oldTable != NULL) {									//old table's bucket if it hasn't been moved
+		int hashVal = hash(key, oldSize);
+		if (hashVal >= rehashIdx) removed = RemoveFromChain(&oldTable[hashVal], key);
+	}
+	if (removed) Shrink();
+}
+
+
+//Called after a node is removed: Halves the table if it is too empty
+template <class K, class V, class Hash, class Equal>
+void HashMap<K, V, Hash, Equal>::Shrink() {
+	count--;
+	if (oldTable == NULL && size > minSize && count < minLoad * size) {
+		int newSize = size / 2;
+		if (newSize < minSize) newSize = minSize;
+		Rehash(newSize);
+	}
+}
+
+
+//Implementing HashTable's "Get_Size" Method
+template <class K, class V, class Hash, class Equal>
+int HashMap<K, V, Hash, Equal>::Get_Size() {
+	return size;							//Return table's private size variable [Encapsulation]
+}
+
+
+template <class K, class V, class Hash, class Equal>
+int HashMap<K, V, Hash, Equal>::Get_Count() {
+	return count;
+}
+
+
+template <class K, class V, class Hash, class Equal>
+double HashMap<K, V, Hash, Equal>::Get_LoadFactor() {
+	if (size == 0) return 0;
+	return (double)count / size;
+}
+
+
+template <class K, class V, class Hash, class Equal>
+bool HashMap<K, V, Hash, Equal>::IsRehashing() {
+	return oldTable != NULL;
+}
+
+
+template <class K, class V, class Hash, class Equal>
+void HashMap<K, V, Hash, Equal>::AddChains(TableStats& stats, Entry** heads, int first, int n) {
+	for (int i = first; i < n; i++) {
+		int length = 0;
+		for (Entry* temp = heads[i]; temp != NULL; temp = temp->Get_p()) length++;
+		if (length > stats.maxChain) stats.maxChain = length;
+		stats.histogram[(length < STATS_HISTOGRAM_SIZE - 1) ? length : STATS_HISTOGRAM_SIZE - 1]++;
+	}
+}
+
+
+template <class K, class V, class Hash, class Equal>
+TableStats HashMap<K, V, Hash, Equal>::GetStats() {
+	TableStats stats;
+	stats.count = count;
+	stats.size = size;
+	stats.loadFactor = Get_LoadFactor();
+	stats.maxChain = 0;
+	for (int i = 0; i < STATS_HISTOGRAM_SIZE; i++) stats.histogram[i] = 0;
+	AddChains(stats, table, 0, size);
+	if (oldTable != NULL) AddChains(stats, oldTable, rehashIdx, oldSize);	//Buckets not moved yet count too
+
+	stats.hits = statHits;
+	stats.misses = statMisses;
+	stats.avgProbesHit = (statHits > 0) ? (double)statHitProbes / statHits : 0;
+	stats.avgProbesMiss = (statMisses > 0) ? (double)statMissProbes / statMisses : 0;
+	stats.rehashes = statRehashes;
+	return stats;
+}
+
+
+template <class K, class V, class Hash, class Equal>
+void HashMap<K, V, Hash, Equal>::PrintStats() {
+	TableStats stats = GetStats();
+	cout << "count " << stats.count << '\n';
+	cout << "size " << stats.size << '\n';
+	cout << "load factor " << stats.loadFactor << '\n';
+	cout << "max chain " << stats.maxChain << '\n';
+	cout << "chain lengths";
+	for (int i = 0; i < STATS_HISTOGRAM_SIZE; i++) cout << ' ' << stats.histogram[i];
+	cout << '\n';
+	cout << "probes per hit " << stats.avgProbesHit << " (" << stats.hits << " searches)" << '\n';
+	cout << "probes per miss " << stats.avgProbesMiss << " (" << stats.misses << " searches)" << '\n';
+	cout << "rehashes " << stats.rehashes << '\n';
+}
+
+
+template <class K, class V, class Hash, class Equal>
+void HashMap<K, V, Hash, Equal>::SetLoadFactors(double minLoadFactor, double maxLoadFactor) {
+	minLoad = minLoadFactor;
+	maxLoad = maxLoadFactor;
+}
+
+
+//Implementing DestroyChain: Runs the destructor of every node in a chain
+template <class K, class V, class Hash, class Equal>
+void HashMap<K, V, Hash, Equal>::DestroyChain(Entry* head) {
+	while (head != NULL) {
+		Entry* next = head->Get_p();
+		head->~Entry();
+		head = next;
+	}
+}
+
+
+//Implementing Clear: Empties the table completely
+template <class K, class V, class Hash, class Equal>
+void HashMap<K, V, Hash, Equal>::Clear() {
+	for (int i = 0; i < size; i++) {
+		while (table[i] != NULL) {
+			Entry* next = table[i]->Get_p();
+			pool.Free(table[i]);
+			table[i] = next;
+		}
+	}
+	for (int i = rehashIdx; oldTable != NULL && i < oldSize; i++) {
+		while (oldTable[i] != NULL) {
+			Entry* next = oldTable[i]->Get_p();
+			pool.Free(oldTable[i]);
+			oldTable[i] = next;
+		}
+	}
+	delete[] table;
+	delete[] oldTable;
+	table = NULL;
+	oldTable = NULL;
+	size = 0;
+	oldSize = 0;
+	rehashIdx = 0;
+	count = 0;
+}
+
+
+//
+// Snapshot file written by HashMap::Save: this header, then one int per
+// bucket [chain length], then every key, then every value [left out if V
+// is empty]. Keys are in chain order, so the chains come back exactly as
+// they were [files are only readable on machines with the same type sizes
+// and byte order]
+//
+const char SNAPSHOT_MAGIC[8] = { 'H', 'T', 'C', 'H', 'A', 'I', 'N', '1' };
+
+struct SnapshotHeader {
+	char magic[8];
+	int keySize;						// sizeof(K)
+	int valueSize;						// sizeof(V) [0 if V is empty]
+	int size;							// Buckets
+	int minSize;						// Size given to CreateTable
+	int count;							// Nodes
+};
+
+
+//Implementing HashTable's "Save" Method
+template <class K, class V, class Hash, class Equal>
+bool HashMap<K, V, Hash, Equal>::Save(const char* path) {
+	static_assert(is_trivially_copyable<K>::value && is_trivially_copyable<V>::value, "Save needs plain data keys and values");
+	while (oldTable != NULL) RehashStep();			//Finish a running resize so there is a single table to write
+
+	ofstream out(path, ios::binary);
+	if (!out) return false;
+
+	SnapshotHeader header;
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header.keySize = sizeof(K);
+	header.valueSize = is_empty<V>::value ? 0 : sizeof(V);
+	header.size = size;
+	header.minSize = minSize;
+	header.count = count;
+
+	vector<int> lengths(size, 0);
+	vector<K> keys;
+	vector<V> values;
+	keys.reserve(count);
+	if (header.valueSize > 0) values.reserve(count);
+	for (int i = 0; i < size; i++) {
+		for (Entry* temp = table[i]; temp != NULL; temp = temp->Get_p()) {	//Flatten every chain, head to tail
+			lengths[i]++;
+			keys.push_back(temp->Get_key());
+			if (header.valueSize > 0) values.push_back(temp->Get_value());
+		}
+	}
+
+	out.write((const char*)&header, sizeof(header));
+	out.write((const char*)lengths.data(), (streamsize)size * sizeof(int));
+	out.write((const char*)keys.data(), (streamsize)keys.size() * sizeof(K));
+	if (header.valueSize > 0) out.write((const char*)values.data(), (streamsize)values.size() * sizeof(V));
+	return (bool)out;
+}
+
+
+//Implementing HashTable's "Load" Method
+template <class K, class V, class Hash, class Equal>
+bool HashMap<K, V, Hash, Equal>::Load(const char* path) {
+	static_assert(is_trivially_copyable<K>::value && is_trivially_copyable<V>::value, "Load needs plain data keys and values");
+	ifstream in(path, ios::binary);
+	if (!in) return false;
+
+	SnapshotHeader header;
+	if (!in.read((char*)&header, sizeof(header))) return false;
+	if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0
+		|| header.keySize != (int)sizeof(K)
+		|| header.valueSize != (is_empty<V>::value ? 0 : (int)sizeof(V))
+		|| header.size <= 0 || header.count < 0) return false;
+
+	vector<int> lengths(header.size);
+	vector<K> keys(header.count);
+	vector<V> values(header.valueSize > 0 ? header.count : 0);
+	in.read((char*)lengths.data(), (streamsize)header.size * sizeof(int));			//Three reads for the whole table
+	in.read((char*)keys.data(), (streamsize)header.count * sizeof(K));
+	if (header.valueSize > 0) in.read((char*)values.data(), (streamsize)header.count * sizeof(V));
+	if (!in) return false;
+
+	int total = 0;
+	int firstBucket = -1;
+	for (int i = 0; i < header.size; i++) {
+		if (lengths[i] < 0) return false;
+		if (lengths[i] > 0 && firstBucket == -1) firstBucket = i;
+		total += lengths[i];
+	}
+	if (total != header.count) return false;
+	if (firstBucket != -1 && hash(keys[0], header.size) != firstBucket) return false;	//Saved with a different hash policy
+
+	Clear();
+	size = header.size;
+	minSize = header.minSize;
+	count = header.count;
+	table = new Entry*[size];
+	int next = 0;
+	for (int i = 0; i < size; i++) {
+		table[i] = NULL;
+		Entry* tail = NULL;
+		for (int j = 0; j < lengths[i]; j++, next++) {		//Relink the chain in saved order [Nodes of a chain are
+			Entry* temp = (header.valueSize > 0) ? pool.Allocate(keys[next], values[next]) : pool.Allocate(keys[next]);
+			if (tail == NULL) table[i] = temp;				//allocated together, so they sit next to each other]
+			else tail->Set_p(temp);
+			tail = temp;
+		}
+	}
+	return true;
+}
+
+
+// Constructor
+template <class K, class V, class Hash, class Equal>
+HashMap<K, V, Hash, Equal>::HashMap() {
+	table = NULL;
+	size = 0;
+	oldTable = NULL;
+	oldSize = 0;
+	rehashIdx = 0;
+	count = 0;
+	minSize = 0;
+	minLoad = 0.25;
+	maxLoad = 1.0;
+	statHits = 0;
+	statMisses = 0;
+	statHitProbes = 0;
+	statMissProbes = 0;
+	statRehashes = 0;
+}
+
+// Destructor
+template <class K, class V, class Hash, class Equal>
+HashMap<K, V, Hash, Equal>::~HashMap() {
+	if (!is_trivially_destructible<Entry>::value) {
+		for (int i = 0; i < size; i++) DestroyChain(table[i]);	//Values like strings own memory: destroy every Node
+		for (int i = rehashIdx; oldTable != NULL && i < oldSize; i++) DestroyChain(oldTable[i]);
+	}
+	delete[] table;
+	delete[] oldTable;
+}
+
+//
+// Prints all Students/Nodes in table from top to bottom, starting at the 
+// head of each list: Used in testing
+//
+template <class K, class V, class Hash, class Equal>
+void HashMap<K, V, Hash, Equal>::PrintTable() {
+	Entry* temp = NULL;
+	for (int i = rehashIdx; oldTable != NULL && i < oldSize; i++) {
+		temp = oldTable[i];								//During a resize, print the buckets not moved yet first
+		while (temp != NULL) {
+			cout << temp->Get_key() << '\n';
+			temp = temp->Get_p();
+		}
+	}
+	for (int i = 0; i < size; i++) {
+		temp = table[i];
+		while (temp != NULL) {
+			cout << temp->Get_key() << '\n';
+			temp = temp->Get_p();
+		}
+	}
+}
+
+//
+// The FlatHashTable class is an open addressing alternative to HashTable
+// [modeled on Google's Swiss table]
+//
+// It has CreateTable, Add, Remove, Get_Size, Get_Count and PrintTable like
+// HashTable, but is not a drop-in replacement for it:
+// - Search returns a pointer to the stored key [int*], not a Node, and
+//   the pointer is only valid until the next Add [which may grow the table]
+// - It stores keys only: there is no value type, and no Emplace, Upsert,
+//   Find, SearchBatch, statistics or Save/Load
+// Code that only tests whether a student is in the table can swap one for
+// the other by comparing the result of Search with NULL
+//
+// Keys are stored inline in one array, so a lookup does not chase Node
+// pointers. A second array holds one control byte per slot: empty, deleted,
+// or the low 7 bits of the key's hash. Slots are probed in groups of 16, and
+// all 16 control bytes of a group are compared with the hash at once using
+// SIMD, so most lookups read one control group and one key
+//
+// The table grows [doubles] when it would be more than 7/8 full
+//
+
+// Control byte values [full slots hold 0..127]
+const signed char CTRL_EMPTY = -128;
+const signed char CTRL_DELETED = -2;
+
+// Slots per probing group
+const int GROUP_SIZE = 16;
+
+//
+// Returns the index of the lowest set bit of a non-zero mask
+//
+int LowestBit(unsigned mask) {
+#if defined(__GNUC__)
+	return __builtin_ctz(mask);
+#else
+	int i = 0;
+	while (!(mask & 1)) {
+		mask >>= 1;
+		i++;
+	}
+	return i;
+#endif
+}
+
+template <class Hash = MurmurHash>
+class FlatHashTable {
+
+private:
+
+	// Number of slots [a power of two, at least GROUP_SIZE]
+	int size;
+
+	// Number of keys stored
+	int count;
+
+	// Empty slots that can still be used before the table must grow
+	int growthLeft;
+
+	// Control bytes and keys, one of each per slot
+	signed char* ctrl;
+	int* keys;
+
+	// Bit i is set if control byte i of the group equals b
+	unsigned Match(const signed char* group, signed char b);
+
+	// Bit i is set if slot i of the group is empty or deleted
+	unsigned MatchFree(const signed char* group);
+
+	// Bit i is set if slot i of the group is empty
+	unsigned MatchEmpty(const signed char* group);
+
+	// Allocates empty arrays of newSize slots and reinserts every key
+	void Rehash(int newSize);
+
+	// Puts key in the first free slot of its probe sequence [no growing]
+	void Insert(int key);
+
+public:
+
+	//
+	// Creates a table with at least "divisor" slots [rounded up to a
+	// power of two, and to at least one group]
+	//
+	void CreateTable(int divisor);
+
+	//
+	// Searches for a student whose SID = key
+	// Returns a pointer to the stored key, or NULL if it is not found
+	//
+	int* Search(int key);
+
+	//
+	// Adds a student with SID = key to the table
+	//
+	void Add(int key);
+
+	//
+	// Adds the student stored at "temp": The key is copied into the
+	// table and the Node is freed [like HashTable, the table owns it]
+	//
+	void Add(Node* temp);
+
+	//
+	// Removes a student whose SID = key from the table
+	// If the student is not in the table, it does nothing
+	//
+	void Remove(int key);
+
+	//
+	// Returns the number of slots in the table
+	//
+	int Get_Size();
+
+	//
+	// Returns the number of students stored in the table
+	//
+	int Get_Count();
+
+	//
+	// Constructor: Initialize arrays to NULL, size & count to 0
+	//
+	FlatHashTable();
+	~FlatHashTable();
+
+	//
+	// Print all students in slot order
+	//
+	void PrintTable();
+};
+
+
+template <class Hash>
+unsigned FlatHashTable<Hash>::Match(const signed char* group, signed char b) {
+#if HASH_SIMD
+	__m128i g = _mm_loadu_si128((const __m128i*)group);
+	return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(b)));	//One compare checks all 16 slots
+#else
+	unsigned mask = 0;
+	for (int i = 0; i < GROUP_SIZE; i++) {
+		if (group[i] == b) mask |= 1u << i;
+	}
+	return mask;
+#endif
+}
+
+
+template <class Hash>
+unsigned FlatHashTable<Hash>::MatchFree(const signed char* group) {
+#if HASH_SIMD
+	__m128i g = _mm_loadu_si128((const __m128i*)group);
+	return (unsigned)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), g));	//Empty and deleted are the only negative bytes
+#else
+	unsigned mask = 0;
+	for (int i = 0; i < GROUP_SIZE; i++) {
+		if (group[i] < -1) mask |= 1u << i;
+	}
+	return mask;
+#endif
+}
+
+
+template <class Hash>
+unsigned FlatHashTable<Hash>::MatchEmpty(const signed char* group) {
+	return Match(group, CTRL_EMPTY);
+}
+
+
+template <class Hash>
+void FlatHashTable<Hash>::CreateTable(int divisor) {
+	delete[] ctrl;
+	delete[] keys;
+	size = (int)NextPowerOfTwo(divisor < GROUP_SIZE ? GROUP_SIZE : divisor);
+	count = 0;
+	growthLeft = size - size / 8;
+	ctrl = new signed char[size];
+	keys = new int[size];
+	for (int i = 0; i < size; i++) {
+		ctrl[i] = CTRL_EMPTY;
+	}
+}
+
+
+template <class Hash>
+void FlatHashTable<Hash>::Insert(int key) {
+	unsigned h = Hash::Hash(key);
+	int groupMask = size / GROUP_SIZE - 1;
+	int group = (int)(h >> 7) & groupMask;					//High bits pick the first group, low 7 bits go in the control byte
+	for (int step = 1; ; step++) {
+		int base = group * GROUP_SIZE;
+		unsigned free = MatchFree(ctrl + base);
+		if (free != 0) {
+			int slot = base + LowestBit(free);
+			if (ctrl[slot] == CTRL_EMPTY) growthLeft--;		//Reusing a deleted slot doesn't use up an empty one
+			ctrl[slot] = (signed char)(h & 0x7F);
+			keys[slot] = key;
+			count++;
+			return;
+		}
+		group = (group + step) & groupMask;					//Triangular probing: visits every group once
+	}
+}
+
+
+template <class Hash>
+void FlatHashTable<Hash>::Rehash(int newSize) {
+	signed char* oldCtrl = ctrl;
+	int* oldKeys = keys;
+	int oldSize = size;
+
+	size = newSize;
+	count = 0;
+	growthLeft = size - size / 8;
+	ctrl = new signed char[size];
+	keys = new int[size];
+	for (int i = 0; i < size; i++) {
+		ctrl[i] = CTRL_EMPTY;
+	}
+	for (int i = 0; i < oldSize; i++) {
+		if (oldCtrl[i] >= 0) Insert(oldKeys[i]);			//Deleted slots are dropped here
+	}
+	delete[] oldCtrl;
+	delete[] oldKeys;
+}
+
+
+template <class Hash>
+int* FlatHashTable<Hash>::Search(int key) {
+	unsigned h = Hash::Hash(key);
+	signed char tag = (signed char)(h & 0x7F);
+	int groupMask = size / GROUP_SIZE - 1;
+	int group = (int)(h >> 7) & groupMask;
+	for (int step = 1; ; step++) {
+		int base = group * GROUP_SIZE;
+		unsigned match = Match(ctrl + base, tag);
+		while (match != 0) {
+			int slot = base + LowestBit(match);				//Only slots whose control byte matches are compared
+			if (keys[slot] == key) return &keys[slot];
+			match &= match - 1;
+		}
+		if (MatchEmpty(ctrl + base) != 0) return NULL;		//An empty slot ends the probe sequence
+		group = (group + step) & groupMask;
+	}
+}
+
+
+template <class Hash>
+void FlatHashTable<Hash>::Add(int key) {
+	if (growthLeft == 0) {
+		if (count >= (size - size / 8) / 2) Rehash(size * 2);	//Mostly real keys: double the table
+		else Rehash(size);										//Mostly deleted slots: clean them up at the same size
+	}
+	Insert(key);
+}
+
+
+template <class Hash>
+void FlatHashTable<Hash>::Add(Node* temp) {
+	Add(temp->Get_key());
+	delete temp;
+}
+
+
+template <class Hash>
+void FlatHashTable<Hash>::Remove(int key) {
+	int* found = Search(key);
+	if (found == NULL) return;
+
+	int slot = (int)(found - keys);
+	int base = slot - slot % GROUP_SIZE;
+	if (MatchEmpty(ctrl + base) != 0) {
+		ctrl[slot] = CTRL_EMPTY;							//Group has an empty slot, so no probe ever went past it:
+		growthLeft++;										//the slot can become empty again
+	}
+	else {
+		ctrl[slot] = CTRL_DELETED;							//Otherwise leave a tombstone so later probes keep going
+	}
+	count--;
+}
+
+
+template <class Hash>
+int FlatHashTable<Hash>::Get_Size() {
+	return size;
+}
+
+
+template <class Hash>
+int FlatHashTable<Hash>::Get_Count() {
+	return count;
+}
+
+
+template <class Hash>
+FlatHashTable<Hash>::FlatHashTable() {
+	ctrl = NULL;
+	keys = NULL;
+	size = 0;
+	count = 0;
+	growthLeft = 0;
+}
+
+
+template <class Hash>
+FlatHashTable<Hash>::~FlatHashTable() {
+	delete[] ctrl;
+	delete[] keys;
+}
+
+
+template <class Hash>
+void FlatHashTable<Hash>::PrintTable() {
+	for (int i = 0; i < size; i++) {
+		if (ctrl[i] >= 0) cout << keys[i] << '\n';
+	}
+}
+
+//
+// ConcurrentNode Class: Chain Node for ConcurrentHashTable
+// [p_next is atomic so readers can follow it while a writer changes it]
+//
+class ConcurrentNode {
 private:
 	int key;
-	Node* p_next;
-	//Other satellite data could be stored here
+	atomic<ConcurrentNode*> p_next;
 
 public:
 	void Set_key(int x);
 	int Get_key();
-	void Set_p(Node* p);
-	Node* Get_p();
-	Node();
+	void Set_p(ConcurrentNode* p);
+	ConcurrentNode* Get_p();
+	ConcurrentNode();
 };
 
-Node::Node() {
+ConcurrentNode::ConcurrentNode() {
 	key = -1;
-	p_next = NULL;
+	p_next.store(NULL);
 }
 
-void Node::Set_key(int x) {
+void ConcurrentNode::Set_key(int x) {
 	key = x;
 }
 
-int Node::Get_key() {
+int ConcurrentNode::Get_key() {
 	return key;
 }
 
-void Node::Set_p(Node* p) {
-	p_next = p;
+void ConcurrentNode::Set_p(ConcurrentNode* p) {
+	p_next.store(p);
 }
 
-Node* Node::Get_p() {
-	return p_next;
+ConcurrentNode* ConcurrentNode::Get_p() {
+	return p_next.load(memory_order_acquire);
 }
 
-// 
-// The HashTable class implements a hash table whose elements 
-// are pointers -> Each pointer points to a linked 
-// list that holds the student(s) at that key
-// 
-class HashTable {
+//
+// EpochManager Class: Decides when memory that readers might still be
+// using can be freed [epoch based reclamation]
+//
+// A reader announces the current epoch while it reads. Removed memory is
+// "retired" with the epoch it was removed in, and the epoch then moves
+// forward. Retired memory is freed once every active reader announced a
+// later epoch, because those readers started after it was unlinked
+//
+// Each reader thread announces in a record of its own, on its own cache
+// line, found through a thread_local cache: Enter and Exit only write to
+// that line, so readers on different cores never contend. Records are kept
+// on a list that only grows, and the record of a thread that exits is
+// reused by the next thread that registers
+//
+const int CACHE_LINE = 64;
+const int EPOCH_RECLAIM_BATCH = 64;
 
+class EpochManager {
 private:
+	struct Retired {
+		void* p;
+		void (*free)(void*);
+		unsigned long long epoch;
+	};
 
-	// Size of the hash table. 
-	int size;
-	
-	// Basic Hash Function
-	int hash(int key);
+	// One reader thread's announcement
+	struct Record {
+		atomic<unsigned long long> epoch;	// 0 while the thread is not reading
+		atomic<bool> inUse;					// false once the thread has exited
+		Record* next;
+		void* raw;							// Allocation the record sits in
+	};
 
-	// Pointer to Table
-	// Pointer of Pointer: Points to Array of Pointers
-	Node** table;
+	// Records of the calling thread, one per manager it has read from
+	// [its destructor frees the records when the thread exits]
+	struct ThreadRecords {
+		vector<pair<unsigned long long, Record*> > records;
+		unsigned long long lastId;
+		Record* last;
+		ThreadRecords();
+		~ThreadRecords();
+	};
+
+	// Ids of the managers that still exist [a thread that exits only
+	// touches records of these, the others were freed with their manager]
+	static mutex registryLock;
+	static vector<unsigned long long> live;
+	static atomic<unsigned long long> nextId;
+
+	// Identifies this manager in ThreadRecords [never reused, unlike its address]
+	unsigned long long id;
+
+	atomic<unsigned long long> globalEpoch;
+
+	// Every record ever registered [only added to, until the destructor]
+	atomic<Record*> records;
+
+	mutex retiredLock;
+	vector<Retired> retired;
+
+	// Returns the calling thread's record, registering it on first use
+	Record* ThisThread();
+
+	// Takes a free record or adds a new one
+	Record* Register();
+
+	// Frees every retired item older than all active readers
+	// [retiredLock must be held]
+	void Reclaim();
 
-	
 public:
+	//
+	// Starts a read: Announces the current epoch
+	//
+	void Enter();
 
 	//
-	// This function creates a hash table using dynamic memory allocation
-	// and initializes all cells to NULL.
-	// 
-	// Creates table whose size is equal to divisor due to the nature of the
-	// basic hash function
+	// Ends the read started by Enter
 	//
-	void CreateTable(int divisor);
+	void Exit();
 
 	//
-	// Searches for a student whose SID = key
-	// If a student is found, return Student Node, otherwise, return NULL
+	// Frees p with free(p) once no reader can still be using it
 	//
-	Node* Search(int key);
+	void Retire(void* p, void (*free)(void*));
 
 	//
-	// This function adds a student (address stored at "temp") to the hash table
+	// Frees everything retired [only when no readers are active]
 	//
-	void Add(Node* temp);
+	void ReclaimAll();
+
+	EpochManager();
+	~EpochManager();
+};
+
+mutex EpochManager::registryLock;
+vector<unsigned long long> EpochManager::live;
+atomic<unsigned long long> EpochManager::nextId(1);
+
+EpochManager::ThreadRecords::ThreadRecords() {
+	lastId = 0;
+	last = NULL;
+}
+
+EpochManager::ThreadRecords::~ThreadRecords() {
+	lock_guard<mutex> guard(registryLock);
+	for (size_t i = 0; i < records.size(); i++) {
+		for (size_t j = 0; j < live.size(); j++) {
+			if (live[j] != records[i].first) continue;
+			records[i].second->epoch.store(0, memory_order_release);	//Manager still exists: hand the
+			records[i].second->inUse.store(false, memory_order_release);	//record to the next thread
+			break;
+		}
+	}
+}
+
+EpochManager::EpochManager() {
+	id = nextId.fetch_add(1);
+	globalEpoch.store(1);
+	records.store(NULL);
+	lock_guard<mutex> guard(registryLock);
+	live.push_back(id);
+}
+
+EpochManager::~EpochManager() {
+	{
+		lock_guard<mutex> guard(registryLock);				//From here on no exiting thread touches our records
+		for (size_t i = 0; i < live.size(); i++) {
+			if (live[i] == id) {
+				live[i] = live.back();
+				live.pop_back();
+				break;
+			}
+		}
+	}
+	ReclaimAll();
+	Record* r = records.load();
+	while (r != NULL) {
+		Record* next = r->next;
+		void* raw = r->raw;
+		r->~Record();
+		::operator delete(raw);
+		r = next;
+	}
+}
+
+EpochManager::Record* EpochManager::ThisThread() {
+	static thread_local ThreadRecords mine;
+	if (mine.lastId == id) return mine.last;				//Usual case: same manager as the last call
+	for (size_t i = 0; i < mine.records.size(); i++) {
+		if (mine.records[i].first == id) {
+			mine.lastId = id;
+			mine.last = mine.records[i].second;
+			return mine.last;
+		}
+	}
+	Record* r = Register();
+	mine.records.push_back(make_pair(id, r));
+	mine.lastId = id;
+	mine.last = r;
+	return r;
+}
+
+EpochManager::Record* EpochManager::Register() {
+	for (Record* r = records.load(memory_order_acquire); r != NULL; r = r->next) {
+		bool expected = false;
+		if (r->inUse.compare_exchange_strong(expected, true)) return r;	//Left by a thread that exited
+	}
+
+	void* raw = ::operator new(2 * CACHE_LINE);				//A cache line of its own: the record starts at the
+	char* line = (char*)(((size_t)raw + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1));	//first line boundary, and
+	Record* r = new (line) Record;							//the rest of that line is ours too
+	r->epoch.store(0);
+	r->inUse.store(true);
+	r->raw = raw;
+	Record* head = records.load();
+	do {
+		r->next = head;
+	} while (!records.compare_exchange_weak(head, r));
+	return r;
+}
+
+void EpochManager::Enter() {
+	Record* r = ThisThread();
+	r->epoch.store(globalEpoch.load(memory_order_acquire), memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);				//Announcement is visible before anything is read [pairs
+}															//with the fence in Reclaim, only touches our own line]
+
+void EpochManager::Exit() {
+	ThisThread()->epoch.store(0, memory_order_release);
+}
+
+void EpochManager::Retire(void* p, void (*free)(void*)) {
+	lock_guard<mutex> guard(retiredLock);
+	Retired r;
+	r.p = p;
+	r.free = free;
+	r.epoch = globalEpoch.fetch_add(1);						//Readers that enter from now on can't reach p
+	retired.push_back(r);
+	if ((int)retired.size() >= EPOCH_RECLAIM_BATCH) Reclaim();
+}
+
+void EpochManager::Reclaim() {
+	atomic_thread_fence(memory_order_seq_cst);				//A reader not seen below will see every unlink before this
+	unsigned long long oldest = globalEpoch.load();
+	for (Record* r = records.load(memory_order_acquire); r != NULL; r = r->next) {
+		unsigned long long e = r->epoch.load(memory_order_acquire);	//Acquire: a reader seen as done has finished its reads
+		if (e != 0 && e < oldest) oldest = e;
+	}
+	size_t kept = 0;
+	for (size_t i = 0; i < retired.size(); i++) {
+		if (retired[i].epoch < oldest) retired[i].free(retired[i].p);	//Every active reader started after this was retired
+		else retired[kept++] = retired[i];
+	}
+	retired.resize(kept);
+}
+
+void EpochManager::ReclaimAll() {
+	lock_guard<mutex> guard(retiredLock);
+	for (size_t i = 0; i < retired.size(); i++) retired[i].free(retired[i].p);
+	retired.clear();
+}
+
+//
+// The ConcurrentHashTable class is a separate chaining table that can be
+// shared by many threads without a global lock
+//
+// Writers [Add/Remove] lock one stripe: the buckets are split into
+// "stripes" groups, each with its own mutex, so writers to different
+// stripes run in parallel. Readers [Search] take no lock at all: chain
+// links are atomic, and removed Nodes are only freed through the
+// EpochManager once no reader can still be walking over them
+//
+// Resizing copies the chains into a new bucket array one stripe at a
+// time, holding only that stripe's lock [a bucket and the two buckets it
+// splits into share a stripe]. Until the new array is published, writers
+// to a stripe that was already copied change both arrays. Publishing is
+// one atomic store under every stripe lock, so readers see either the old
+// or the new array, and the old one is retired like a removed Node
+//
+template <class Hash = MurmurHash>
+class ConcurrentHashTable {
+
+private:
+
+	// One bucket array [replaced as a whole when the table resizes]
+	struct Buckets {
+		int size;
+		atomic<ConcurrentNode*>* heads;
+	};
+
+	atomic<Buckets*> table;
+
+	// Array being filled by Grow [NULL when not growing]. migrated[s] is
+	// true once stripe s was copied to it [guarded by stripe s]
+	atomic<Buckets*> growing;
+	bool* migrated;
+
+	// Held by the thread growing the table
+	mutex growLock;
+
+	// Stripe locks [stripeCount is a power of two that divides every table size]
+	mutex* stripes;
+	int stripeCount;
+
+	atomic<int> count;
+	double maxLoad;
+
+	EpochManager epochs;
+
+	// Stripe that guards key [independent of the table size]
+	int Stripe(int key);
+
+	// Allocates an empty bucket array
+	static Buckets* NewBuckets(int size);
+
+	// Frees a bucket array and every Node in it [used by the EpochManager]
+	static void FreeBuckets(void* p);
+
+	// Frees a single Node [used by the EpochManager]
+	static void FreeNode(void* p);
+
+	// Doubles the table if it is over maxLoad [one stripe at a time]
+	void Grow();
+
+	// Adds a copy of temp to the chain for its key in b
+	static void LinkCopy(Buckets* b, ConcurrentNode* temp);
+
+public:
 
 	//
-	// This function removes a student whose SID = key from the table
-	// If the student is not in the table, it does nothing
+	// Creates a table with at least "divisor" buckets and "stripeLocks"
+	// stripes [both rounded up to powers of two]
 	//
-	void Remove(int key);
+	void CreateTable(int divisor, int stripeLocks = 16);
 
 	//
-	// Returns the table size [Held in private size variable]
+	// Returns true if a student whose SID = key is in the table
+	// [lock free, safe to call while other threads write]
 	//
-	int Get_Size();
+	bool Search(int key);
 
+	//
+	// Adds a student with SID = key to the table
+	//
+	void Add(int key);
 
 	//
-	// Constructor: Initialize table to NULL, size to 0
+	// Removes a student whose SID = key from the table
+	// If the student is not in the table, it does nothing
 	//
-	HashTable();
+	void Remove(int key);
 
+	//
+	// Returns the number of buckets in the table
+	//
+	int Get_Size();
 
-	// 
-	// Print all Nodes/Students in table from top to bottom
 	//
-	void PrintTable();
+	// Returns the number of students stored in the table
+	//
+	int Get_Count();
+
+	ConcurrentHashTable();
+	~ConcurrentHashTable();
 };
 
 
-//Implementing basic hash function using modulo operator and table size
-int HashTable::hash(int key) {
-	return key % size;
+template <class Hash>
+int ConcurrentHashTable<Hash>::Stripe(int key) {
+	return (int)Reduce(Hash::Hash(key), (unsigned)stripeCount);
 }
 
 
-//Implementing CreateTable Method
-void HashTable::CreateTable(int divisor) {
-	size = divisor;						//Step 1: Setting size equal to divisor
-										//[Modulo divisor directly indicates table size]
-	table = new Node*[size];
-	for (int i = 0; i < size; i++) {	//Step 2: Initialize table using size, fill table values with NULL
-		table[i] = NULL;
+template <class Hash>
+typename ConcurrentHashTable<Hash>::Buckets* ConcurrentHashTable<Hash>::NewBuckets(int size) {
+	Buckets* b = new Buckets;
+	b->size = size;
+	b->heads = new atomic<ConcurrentNode*>[size];
+	for (int i = 0; i < size; i++) b->heads[i].store(NULL);
+	return b;
+}
+
+
+template <class Hash>
+void ConcurrentHashTable<Hash>::FreeBuckets(void* p) {
+	Buckets* b = (Buckets*)p;
+	for (int i = 0; i < b->size; i++) {
+		ConcurrentNode* temp = b->heads[i].load();
+		while (temp != NULL) {
+			ConcurrentNode* next = temp->Get_p();
+			delete temp;
+			temp = next;
+		}
 	}
+	delete[] b->heads;
+	delete b;
+}
+
+
+template <class Hash>
+void ConcurrentHashTable<Hash>::FreeNode(void* p) {
+	delete (ConcurrentNode*)p;
 }
 
 
-Node* HashTable::Search(int key) {
-	int hashVal = hash(key);		//Call hash function to get search value
-	Node* temp = table[hashVal];	//Initialize temp Node at head to traverse list
+template <class Hash>
+void ConcurrentHashTable<Hash>::CreateTable(int divisor, int stripeLocks) {
+	stripeCount = (int)NextPowerOfTwo(stripeLocks < 1 ? 1 : stripeLocks);
+	stripes = new mutex[stripeCount];
+	migrated = new bool[stripeCount];
+	for (int i = 0; i < stripeCount; i++) migrated[i] = false;
+	int size = (int)NextPowerOfTwo(divisor < stripeCount ? stripeCount : divisor);	//Every bucket belongs to exactly one stripe
+	table.store(NewBuckets(size));
+	count.store(0);
+}
+
 
+template <class Hash>
+bool ConcurrentHashTable<Hash>::Search(int key) {
+	epochs.Enter();											//Nothing read from here on is freed until Exit
+	Buckets* b = table.load(memory_order_acquire);
+	ConcurrentNode* temp = b->heads[Reduce(Hash::Hash(key), (unsigned)b->size)].load(memory_order_acquire);
+	bool found = false;
 	while (temp != NULL) {
-		if (temp->Get_key() == key) return temp;	//While temp is not NULL(end of list) test if key equals search key
+		if (temp->Get_key() == key) {
+			found = true;
+			break;
+		}
 		temp = temp->Get_p();
-	}												//If key is found, return temp Node
-	
-	return NULL;					//If the entire list is traversed and nothing found, return NULL
+	}
+	epochs.Exit();
+	return found;
 }
 
 
-//Implementing HashTable's "Add" Method
-void HashTable::Add(Node* temp) {
-	int hashVal = hash(temp->Get_key());	//Hash the nodes value to find table insertion point
-
-	temp->Set_p(table[hashVal]);		//Collision: If point in table already has data,
-	table[hashVal] = temp;				//connect it to the temp node to form linked list w/ temp at head
+template <class Hash>
+void ConcurrentHashTable<Hash>::Add(int key) {
+	ConcurrentNode* temp = new ConcurrentNode;
+	temp->Set_key(key);
+	int size;
+	{
+		lock_guard<mutex> guard(stripes[Stripe(key)]);		//Holding a stripe keeps the table from being resized
+		Buckets* b = table.load();
+		atomic<ConcurrentNode*>& head = b->heads[Reduce(Hash::Hash(key), (unsigned)b->size)];
+		temp->Set_p(head.load());							//Node is complete before it is published
+		head.store(temp, memory_order_release);
+		size = b->size;
+		Buckets* next = growing.load(memory_order_acquire);
+		if (next != NULL && migrated[Stripe(key)]) LinkCopy(next, temp);	//Stripe already copied by Grow
+	}
+	if (count.fetch_add(1) + 1 > maxLoad * size) Grow();	//Stripe is released first, Grow needs every stripe
 }
 
 
-//Implementing HashTable's "Remove" Method
-void HashTable::Remove(int key) {
-	int hashVal = hash(key);						//Call hash function to get HashTable search value
+template <class Hash>
+void ConcurrentHashTable<Hash>::Remove(int key) {
+	ConcurrentNode* toDel = NULL;
+	{
+		lock_guard<mutex> guard(stripes[Stripe(key)]);
+		Buckets* b = table.load();
+		atomic<ConcurrentNode*>* link = &b->heads[Reduce(Hash::Hash(key), (unsigned)b->size)];
+		ConcurrentNode* prev = NULL;
+		ConcurrentNode* temp = link->load();
+		while (temp != NULL && temp->Get_key() != key) {
+			prev = temp;
+			temp = temp->Get_p();
+		}
+		if (temp == NULL) return;
 
-	if (table[hashVal] == NULL) return;				//Edge Case 1: If that table value is empty, return without doing anything
+		if (prev == NULL) link->store(temp->Get_p());		//Unlink: readers already on temp can still follow its p_next
+		else prev->Set_p(temp->Get_p());
+		toDel = temp;
 
-	if (table[hashVal]->Get_key() == key) {			//Edge Case 2: If the head of the linked list at that table value is the
-		Node* toDel = table[hashVal];				//Node we want to remove, move the table pointer to the next node and
-		table[hashVal] = table[hashVal]->Get_p();	//free the memory
-		delete toDel;
-		return;
+		Buckets* next = growing.load(memory_order_acquire);
+		if (next != NULL && migrated[Stripe(key)]) {		//Stripe already copied by Grow: remove the copy too
+			link = &next->heads[Reduce(Hash::Hash(key), (unsigned)next->size)];
+			prev = NULL;
+			temp = link->load();
+			while (temp->Get_key() != key) {
+				prev = temp;
+				temp = temp->Get_p();
+			}
+			if (prev == NULL) link->store(temp->Get_p());
+			else prev->Set_p(temp->Get_p());
+			delete temp;									//No reader can see the new array yet
+		}
 	}
-													//Main Logic
+	count.fetch_sub(1);
+	epochs.Retire(toDel, FreeNode);							//Freed later, once no reader can be on it
+}
 
-	Node* temp = table[hashVal];					//Initialize temp pointer to traverse list at hashed table value
-	while (temp->Get_p() != NULL) {
-		if (temp->Get_p()->Get_key() == key) {		//Searching forward: If next node has the value we want to remove:
-			Node* toDel = temp->Get_p();			//1. Connect current node to node on other side of value to be removed
-			temp->Set_p(toDel->Get_p());			//2. Free memory in removed node
-			delete toDel;
-			return;									//Return: Once it is found, no need to look anymore
+
+template <class Hash>
+void ConcurrentHashTable<Hash>::LinkCopy(Buckets* b, ConcurrentNode* temp) {
+	ConcurrentNode* copy = new ConcurrentNode;				//Copy instead of relinking: readers may still walk the old chains
+	copy->Set_key(temp->Get_key());
+	atomic<ConcurrentNode*>& head = b->heads[Reduce(Hash::Hash(copy->Get_key()), (unsigned)b->size)];
+	copy->Set_p(head.load());
+	head.store(copy);
+}
+
+
+template <class Hash>
+void ConcurrentHashTable<Hash>::Grow() {
+	unique_lock<mutex> grower(growLock, try_to_lock);
+	if (!grower.owns_lock()) return;							//Another thread is growing the table already
+
+	Buckets* oldBuckets = table.load();
+	if (count.load() <= maxLoad * oldBuckets->size) return;		//Or has just grown it
+
+	Buckets* newBuckets = NewBuckets(oldBuckets->size * 2);
+	growing.store(newBuckets, memory_order_release);
+	for (int s = 0; s < stripeCount; s++) {
+		lock_guard<mutex> guard(stripes[s]);					//Only writers to stripe s wait, and only while it is copied
+		for (int i = s; i < oldBuckets->size; i += stripeCount) {	//Buckets of stripe s [stripeCount divides the size]
+			for (ConcurrentNode* temp = oldBuckets->heads[i].load(); temp != NULL; temp = temp->Get_p()) {
+				LinkCopy(newBuckets, temp);
+			}
 		}
+		migrated[s] = true;
 	}
+
+	for (int i = 0; i < stripeCount; i++) stripes[i].lock();	//Publish: no writer is between changing the old array
+	table.store(newBuckets, memory_order_release);				//and the new one [always locked in the same order]
+	growing.store(NULL);
+	for (int i = 0; i < stripeCount; i++) migrated[i] = false;
+	for (int i = stripeCount - 1; i >= 0; i--) stripes[i].unlock();
+	epochs.Retire(oldBuckets, FreeBuckets);
 }
 
 
-//Implementing HashTable's "Get_Size" Method
-int HashTable::Get_Size() {
-	return size;							//Return table's private size variable [Encapsulation]
+template <class Hash>
+int ConcurrentHashTable<Hash>::Get_Size() {
+	epochs.Enter();											//Grow may retire the array while we read it
+	int size = table.load(memory_order_acquire)->size;
+	epochs.Exit();
+	return size;
 }
 
 
-// Constructor
-HashTable::HashTable() {
-	table = NULL;
-	size = 0;
+template <class Hash>
+int ConcurrentHashTable<Hash>::Get_Count() {
+	return count.load();
 }
 
-//
-// Prints all Students/Nodes in table from top to bottom, starting at the 
-// head of each list: Used in testing
-//
-void HashTable::PrintTable() {
-	Node* temp = NULL;
-	for (int i = 0; i < size; i++) {
-		temp = table[i];
-		while (temp != NULL) {
-			cout << temp->Get_key() << '\n';
-			temp = temp->Get_p();
-		}
-	}
+
+template <class Hash>
+ConcurrentHashTable<Hash>::ConcurrentHashTable() {
+	table.store(NULL);
+	growing.store(NULL);
+	migrated = NULL;
+	stripes = NULL;
+	stripeCount = 0;
+	count.store(0);
+	maxLoad = 1.0;
+}
+
+
+template <class Hash>
+ConcurrentHashTable<Hash>::~ConcurrentHashTable() {
+	epochs.ReclaimAll();
+	if (table.load() != NULL) FreeBuckets(table.load());
+	delete[] stripes;
+	delete[] migrated;
 }
 
 // 
@@ -220,19 +2072,33 @@ int main()
 
 	Node* Student;
 
-	HashTable x;
+	HashTable<> x;
+
+	// Open addressing table, filled with the same students
+	FlatHashTable<> y;
+
+	// SID -> position of its last appearance in the input
+	HashMap<int, int> position;
+	int order = 0;
+
+	// Every SID read, in order
+	vector<int> input;
 
 	cin >> mode >> key >> divisor;
 
 	x.CreateTable(divisor);
+	y.CreateTable(divisor);
+	position.CreateTable(divisor);
 
 	while (cin >> temp) {
 
-		Student = new Node;
+		x.Emplace(temp);
 
-		Student->Set_key(temp);
+		y.Add(temp);
 
-		x.Add(Student);
+		position.Upsert(temp, order++);
+
+		input.push_back(temp);
 	}
 
 	// Mode 0: test table size 
@@ -262,6 +2128,76 @@ int main()
 		x.PrintTable();
 	}
 
+	// Mode 4: test FlatHashTable's "Search" function 
+	else if (mode == 4) {
+		int* found = y.Search(key);
+		if (found == NULL) {
+			cout << -1;
+		}
+		else {
+			cout << *found;
+		}
+	}
+
+	// Mode 5: test the statistics [after searching for key]
+	else if (mode == 5) {
+		x.Search(key);
+		x.PrintStats();
+	}
+
+	// Mode 6: test HashMap's "Upsert" and "Find" functions [last position of key]
+	else if (mode == 6) {
+		HashMap<int, int>::Entry* found = position.Find(key);
+		if (found == NULL) {
+			cout << -1;
+		}
+		else {
+			cout << found->Get_value();
+		}
+	}
+
+	// Mode 7: test "Save" and "Load" [prints the loaded copy of the table]
+	else if (mode == 7) {
+		HashTable<> copy;
+		if (x.Save("chaining.snapshot") && copy.Load("chaining.snapshot")) {
+			copy.PrintTable();
+		}
+		remove("chaining.snapshot");
+	}
+
+	// Mode 8: test ConcurrentHashTable [4 threads add the students while
+	// this thread searches for key, then prints the result like mode 2]
+	else if (mode == 8) {
+		ConcurrentHashTable<> c;
+		c.CreateTable(divisor, 4);
+		vector<thread> writers;
+		for (int t = 0; t < 4; t++) {
+			writers.push_back(thread([&c, &input, t]() {
+				for (size_t i = t; i < input.size(); i += 4) c.Add(input[i]);
+			}));
+		}
+		for (int i = 0; i < 1000; i++) c.Search(key);
+		for (size_t t = 0; t < writers.size(); t++) writers[t].join();
+		cout << (c.Search(key) ? key : -1);
+	}
+
+	// Mode 9: test "SearchBatch" [searches key and every student in one
+	// batch, prints each result like mode 2, one per line]
+	else if (mode == 9) {
+		vector<int> keys(1, key);
+		keys.insert(keys.end(), input.begin(), input.end());
+		vector<HashTable<>::Entry*> found(keys.size());
+		x.SearchBatch(&keys[0], (int)keys.size(), &found[0]);
+		for (size_t i = 0; i < found.size(); i++) {
+			if (found[i] == NULL) {
+				cout << -1 << '\n';
+			}
+			else {
+				cout << found[i]->Get_key() << '\n';
+			}
+		}
+	}
+
 	return 0;
 }
 
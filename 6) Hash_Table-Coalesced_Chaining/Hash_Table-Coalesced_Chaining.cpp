@@ -4,6 +4,24 @@
 // using singly linked list 
 // 
 #include <iostream>
+#include <atomic>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HASH_MMAP 1
+#else
+#define HASH_MMAP 0
+#endif
 using namespace std;
 
 
@@ -11,6 +29,8 @@ using namespace std;
 // Basic Node class used to facilitate Hash Table implementation:
 // NOTE: int idx_next is stored instead of pointer p_next to 
 // allow for coalesced chaining in the table
+// [HashTable takes students as Nodes, but stores keys and next
+// indexes in separate arrays]
 //
 class Node {
 private:
@@ -47,14 +67,162 @@ int Node::Get_index() {
 
 
 
+//
+// Hash policies: HashTable is a template over one of these classes. Each
+// one has a static Hash(key) that turns a key into a 32-bit value, and the
+// table reduces that value to a bucket with a mask when its size is a
+// power of two, or with modulo for any other size
+//
+// IdentityHash: The key itself [default, gives the original key % size,
+//               good for keys that are already random]
+// FibonacciHash: Multiplies by 2^64 / golden ratio and keeps the high bits,
+//                so clustered or strided keys spread over the whole table
+//                [bit-reversed, so a power-of-two table's mask takes the top
+//                log2(size) bits of the product, as Knuth's method does]
+// MurmurHash: Murmur3's 32-bit finalizer, every key bit changes about half
+//             of the hash bits
+//
+// All of them hash through unsigned, so negative keys still give a valid bucket
+//
+class IdentityHash {
+public:
+	static unsigned Hash(int key) {
+		return (unsigned)key;
+	}
+};
+
+class FibonacciHash {
+public:
+	static unsigned Hash(int key) {
+		unsigned h = (unsigned)(((unsigned long long)(unsigned)key * 11400714819323198485ull) >> 32);
+		h = ((h >> 1) & 0x55555555u) | ((h & 0x55555555u) << 1);	//Reverse the bits, so the low bits Reduce
+		h = ((h >> 2) & 0x33333333u) | ((h & 0x33333333u) << 2);	//masks are the top bits of the product
+		h = ((h >> 4) & 0x0F0F0F0Fu) | ((h & 0x0F0F0F0Fu) << 4);
+		h = ((h >> 8) & 0x00FF00FFu) | ((h & 0x00FF00FFu) << 8);
+		return (h >> 16) | (h << 16);
+	}
+};
+
+class MurmurHash {
+public:
+	static unsigned Hash(int key) {
+		unsigned h = (unsigned)key;
+		h ^= h >> 16;
+		h *= 0x85ebca6bu;
+		h ^= h >> 13;
+		h *= 0xc2b2ae35u;
+		h ^= h >> 16;
+		return h;
+	}
+};
+
+//
+// Reduces hash value h to a bucket of a table with tableSize buckets
+// [a mask for power of two sizes, modulo otherwise]
+//
+unsigned Reduce(unsigned h, unsigned tableSize) {
+	if ((tableSize & (tableSize - 1)) == 0) return h & (tableSize - 1);
+	return h % tableSize;
+}
+
+//
+// Statistics: HashTable counts searches and probes as it runs, and
+// GetStats() adds a scan of the table. The counters are a few additions
+// per Search, and building with HASH_STATS defined as 0 removes them
+//
+#ifndef HASH_STATS
+#define HASH_STATS 1
+#endif
+#if HASH_STATS
+#define STATS(x) x
+#else
+#define STATS(x)
+#endif
+
+// Chain lengths 0 .. STATS_HISTOGRAM_SIZE - 2 get their own histogram
+// entry, longer chains all go in the last one
+const int STATS_HISTOGRAM_SIZE = 16;
+
+//
+// The chain of home slot i is every slot Search walks from table[i] [0 if
+// the slot is empty] -> Coalesced chains share slots, so a slot can be
+// counted in more than one chain. Cellar slots are not home slots
+//
+struct TableStats {
+	int count;							// Students stored
+	int size;							// Slots
+	double loadFactor;					// count / size
+	int maxChain;						// Longest chain
+	int histogram[STATS_HISTOGRAM_SIZE];	// Number of home slots with each chain length
+	long long hits;						// Successful searches
+	long long misses;					// Unsuccessful searches
+	double avgProbesHit;				// Slots compared per successful search
+	double avgProbesMiss;				// Slots compared per unsuccessful search
+	int rehashes;						// Resizes
+};
+
+//
+// Snapshot file: this header followed by the table's arrays [occupancy
+// bitmap, keys, next indexes], exactly as they are in memory. Chains are
+// stored as slot indexes, not pointers, so the arrays can be mapped back
+// into memory and searched as they are [files are only readable on
+// machines with the same int size and byte order]
+//
+const char SNAPSHOT_MAGIC[8] = { 'H', 'T', 'C', 'O', 'A', 'L', '0', '2' };
+
+// Key hashed into every snapshot, so a table using a different hash
+// policy refuses to load it
+const int SNAPSHOT_CHECK_KEY = 0x2545F491;
+
+struct SnapshotHeader {
+	char magic[8];
+	int size;							// Slots
+	int origDiv;						// Divisor of the hash function
+	int indexSize;						// sizeof(Index) when written
+	unsigned hashCheck;					// Hash::Hash(SNAPSHOT_CHECK_KEY)
+};
+
 // 
+// Returns the position of the highest set bit of x [x != 0]
+//
+int HighestBit(unsigned long long x) {
+#if defined(__GNUC__)
+	return 63 - __builtin_clzll(x);
+#else
+	int i = 63;
+	while (!(x >> i)) i--;
+	return i;
+#endif
+}
+
+//
 // The HashTable class implements a hash table that addresses collisions
 // with coalesced chaining
 // 
-// The table is stored as an array of Node objects -> When the table/array
-// is filled, it is resized by doubling size of array/table and rehashing
-// elements
+// The table is stored as separate arrays [struct of arrays]: the keys,
+// the index of the next slot in each slot's chain, and an occupancy bitmap
+// with one bit per slot. A slot is empty when its bit is clear, so every
+// int [-1 too] can be a key, and free slots are found 64 at a time. When
+// the table is filled, it is resized by doubling size of array/table and
+// rehashing elements: every key is hashed again with the new divisor and
+// added to the new table, so chains are rebuilt instead of growing
+// 
+// "Hash" is one of the hash policies above [a power of two divisor
+// lets hashing use a mask instead of a division]
+// 
+// "Index" is the type of the next indexes: int by default, unsigned short
+// for tables of at most 65535 slots [half the memory for next indexes and
+// the chain arrays]. The table never grows past the largest Index
+//
+// Cellar: Keys hash into the first origDiv slots [the address region],
+// and the slots after it form a cellar that only collisions use. Free
+// slots are taken from the top of the table, so the cellar fills first,
+// and chains only start taking other keys' home slots [and merging with
+// their chains] once it is full. The address factor, origDiv / size, sets
+// the split: 1.0 is no cellar, and about 0.86 gives the fewest probes per
+// search for a table of a given size [Vitter]
 // 
+template <class Hash = IdentityHash, class Index = int>
 class HashTable {
 
 private:
@@ -62,17 +230,89 @@ private:
 	// Size of the hash table. 
 	int size;
 
-	// Stores original divisor when Hash Table is created [For Hash Function]
+	// Divisor of the hash function [size * address factor, changes when the
+	// table is resized]. Slots origDiv to size - 1 are the cellar
 	int origDiv;
 
-	// Basic hash function that returns key % divisor
+	// Address region / table size given to CreateTable
+	double addressFactor;
+
+	// Hash function: Hash policy, then reduced to a home slot with origDiv
 	int hash(int key);
 
-	// Pointer to the hash table [Array of Nodes]  
-	Node* table;
+	// The table: keys[i] and next[i] are the key and next slot of slot i
+	// [next is NO_SLOT at the end of a chain and in every free slot], bit
+	// i of used is set if slot i holds a key
+	int* keys;
+	Index* next;
+	unsigned long long* used;
+
+	// Next index meaning "end of chain" [also the most slots a table can have]
+	static const Index NO_SLOT = (Index)-1;
+
+	// Mapped snapshot file holding the table [NULL if table was allocated]
+	char* mapBase;
+	size_t mapLength;
+
+	// Slot access
+	bool IsUsed(int slot);
+	void SetUsed(int slot, bool inUse);
+	int Next(int slot);						// -1 at the end of a chain
+	void SetNext(int slot, int n);			// n = -1 ends the chain
+
+	// Resizes Hash Table to newSize slots and re-hashes elements
+	void Resize(int newSize);
+
+	// Adds key without resizing, returns false if the table is full
+	bool Insert(int key);
+
+	// Largest size an Index can address
+	int MaxSize();
+
+	// Chains: Every slot in use belongs to one chain [slots linked by
+	// next], named by its first slot. chainOf[i] is the chain of slot
+	// i [only for slots in use], chainTail[c] the last slot of chain c
+	// Chains never merge: a key whose home slot is taken goes at the tail
+	// of that slot's chain, so Add links a new slot without walking
+	Index* chainOf;
+	Index* chainTail;
+
+	// Free slots: slots freed by Remove, then the "R pointer" [every
+	// slot at or above freeTop is in use or in freeSlots]
+	vector<int> freeSlots;
+	int freeTop;
+
+	// False after Load/Map until the chain arrays are rebuilt [done by
+	// the first Add or Remove, so a mapped table is searched as it is]
+	bool chainsBuilt;
 
-	// Resizes Hash Table and re-hashes elements
-	void Resize();
+	// Rebuilds chainOf, chainTail and the free slots from the table
+	void RebuildChains();
+
+	// Returns a free slot [-1 if the table is full]
+	int FreeSlot();
+
+	// Frees or unmaps the table's arrays
+	void FreeTable();
+
+	// Returns true if header describes a snapshot this table can use
+	bool CheckHeader(const SnapshotHeader& header);
+
+	// Points keys, next and used into a snapshot's arrays at base
+	void SetArrays(char* base);
+
+	// Bytes of a snapshot of a table with n slots [header included]
+	size_t SnapshotLength(int n);
+
+	// Search/resize counters [see TableStats]
+	long long statHits;
+	long long statMisses;
+	long long statHitProbes;
+	long long statMissProbes;
+	int statRehashes;
+
+	// Adds one search that compared "probes" slots to the counters, returns result
+	int RecordSearch(int result, int probes);
 
 public:
 
@@ -80,7 +320,12 @@ public:
 	// Creates a hash table (through dynamic memory allocation) and initializes all cells to NULL.
 	// Creates a table with size = divisor [due to nature of basic hash function]
 	// 
-	void CreateTable(int divisor);
+	// With an address factor below 1, keys hash into the first
+	// divisor * factor slots and the rest are the cellar
+	// [0.86 is the usual choice: fewest probes per search, successful or
+	// not, from Vitter's analysis]
+	// 
+	void CreateTable(int divisor, double factor = 1.0);
 
 
 	// 
@@ -93,15 +338,35 @@ public:
 
 	// 
 	// Adds a student to the hash table
-	// Uses linear probing to look for an empty cell in the
-	// case of a collision
+	// In the case of a collision, takes a free slot [see FreeSlot] and
+	// links it at the tail of the home slot's chain, both in O(1)
 	// 
 	void Add(Node temp);
 
 
+	// 
+	// Makes room for n students [in total] with at most one resize, so
+	// adding them does not resize the table again and again
+	// 
+	void Reserve(int n);
+
+
+	// 
+	// Replaces the table's students with the n SIDs in newKeys, sizing
+	// the table once [as Reserve would] and placing every key that finds
+	// its home slot empty before any key is linked into a chain, so chain
+	// slots never take another key's home slot. Linear in n + size
+	// 
+	void BuildFrom(const int* newKeys, int n);
+
+
 	// 
 	// Removes a student whose SID = key from the table
 	// If the student is not in the table, it does nothing. 
+	// 
+	// The students after it in its chain are added again, so every
+	// student stays reachable from its home slot and no slot is left
+	// empty in the middle of a chain [costs one pass over the chain]
 	//
 	void Remove(int key);
 
@@ -112,159 +377,944 @@ public:
 	int Get_Size();
 
 
+	//
+	// Writes the table to file "path" [header, then the arrays as they are]
+	// Returns false if the file can't be written
+	//
+	bool Save(const char* path);
+
+
+	//
+	// Replaces the table with the one saved at "path", read in one piece
+	// [nothing is re-hashed]. Returns false, leaving the table unchanged,
+	// if the file is missing, cut short, or was saved by a table with a
+	// different hash policy or Index type
+	//
+	bool Load(const char* path);
+
+
+	//
+	// Same as Load, but maps the file into memory instead of reading it,
+	// so the table is usable at once and pages are read as they are
+	// touched. The mapping is private: changes stay in memory and the
+	// file is never written [uses Load where mmap is not available]
+	//
+	bool Map(const char* path);
+
+
+	//
+	// Returns count, load factor, chain length histogram, longest chain,
+	// average probes per search and number of resizes
+	// [search and resize numbers are 0 if HASH_STATS is 0]
+	//
+	TableStats GetStats();
+
+
+	//
+	// Prints GetStats() in a readable form
+	//
+	void PrintStats();
+
+
 	// 
 	// Constructor: Initializes table to NULL, size & origDiv to 0
 	//
 	HashTable();
 
 
+	//
+	// Destructor: Frees or unmaps the table
+	//
+	~HashTable();
+
+
 	// 
-	// First print function used for testing: simply prints all Nodes
-	// from table[0] to table[size - 1] in order
+	// First print function used for testing: simply prints all keys
+	// from slot 0 to slot size - 1 in order [-1 for an empty slot]
 	//
 	void PrintTable();
 
 
 	// 
 	// Second print function used for testing: Given a key, it hashes
-	// and prints out the chain of Nodes starting at that hashed value
+	// and prints out the chain of keys starting at that hashed value
+	// [-1 if that slot is empty]
 	// 
 	// Used to test coalesced chaining
 	//
 	void PrintChain(int key);
 };
 
-int HashTable::hash(int key) {
-	return key % origDiv;			//Basic hash function
+template <class Hash, class Index>
+int HashTable<Hash, Index>::hash(int key) {
+	return (int)Reduce(Hash::Hash(key), (unsigned)origDiv);		//Mask or modulo with the divisor
+}
+
+template <class Hash, class Index>
+bool HashTable<Hash, Index>::IsUsed(int slot) {
+	return (used[slot >> 6] >> (slot & 63)) & 1;
+}
+
+template <class Hash, class Index>
+void HashTable<Hash, Index>::SetUsed(int slot, bool inUse) {
+	if (inUse) used[slot >> 6] |= 1ull << (slot & 63);
+	else used[slot >> 6] &= ~(1ull << (slot & 63));
+}
+
+template <class Hash, class Index>
+int HashTable<Hash, Index>::Next(int slot) {
+	return (next[slot] == NO_SLOT) ? -1 : (int)next[slot];
 }
 
-void HashTable::CreateTable(int divisor) {
-	origDiv = divisor;
+template <class Hash, class Index>
+void HashTable<Hash, Index>::SetNext(int slot, int n) {
+	next[slot] = (n == -1) ? NO_SLOT : (Index)n;
+}
+
+template <class Hash, class Index>
+int HashTable<Hash, Index>::MaxSize() {
+	return (numeric_limits<Index>::max() < INT_MAX) ? (int)numeric_limits<Index>::max() : INT_MAX;
+}
+
+template <class Hash, class Index>
+void HashTable<Hash, Index>::CreateTable(int divisor, double factor) {
+	if (divisor > MaxSize()) divisor = MaxSize();	//Index can't address more slots
+	addressFactor = factor;
+	origDiv = (int)(divisor * factor + 0.5);	//Address region, the rest of the table is the cellar
+	if (origDiv < 1) origDiv = 1;
+	if (origDiv > divisor) origDiv = divisor;
 	size = divisor;
-	table = new Node[size];					//Set size of table to divisor, initialize table with that size
+	int words = (size + 63) / 64;
+	keys = new int[size];						//Set size of table to divisor, initialize table with that size
+	next = new Index[size];
+	used = new unsigned long long[words];
 	for (int i = 0; i < size; i++) {
-		table[i].Set_key(-1);				//Setting key to -1 indicates all cells are empty
-		table[i].Set_index(-1);
+		keys[i] = 0;
+		next[i] = NO_SLOT;
 	}
+	for (int i = 0; i < words; i++) used[i] = 0;	//Clear bits indicate all cells are empty
+	RebuildChains();
 }
 
-int HashTable::Search(int key) {
-	int hashed = hash(key);
-	if (table[hashed].Get_key() == key) return hashed;				//First Case: Check at Location in Table
-	Node* traverser = &table[hashed];
-	while (traverser->Get_index() != -1) {							//Second Case: Check down the chain, return index if key is found
-		if (table[traverser->Get_index()].Get_key() == key) return traverser->Get_index();
-		traverser = &table[traverser->Get_index()];
+template <class Hash, class Index>
+int HashTable<Hash, Index>::Search(int key) {
+	int probes = 1;
+	int slot = hash(key);
+	if (!IsUsed(slot)) return RecordSearch(-1, probes);		//First Case: Empty home slot [no chain starts here]
+	while (keys[slot] != key) {								//Second Case: Check down the chain, return index if key is found
+		slot = Next(slot);
+		if (slot == -1) return RecordSearch(-1, probes);	//Third Case: If the end of the chain is reached, return -1 [Not found]
+		STATS(probes++);
 	}
-	return -1;														//Third Case: If the end of the chain is reached, return -1 [Not found]														
+	return RecordSearch(slot, probes);
 }
 
-void HashTable::Resize() {
-	size = size * 2;
-	Node* temp = new Node[size];					//Create new table with double the size
-	int i;
-	for (i = 0; i < size / 2; i++) {				//Fill first half with old values
-		temp[i].Set_key(table[i].Get_key());
-		temp[i].Set_index(table[i].Get_index());
+template <class Hash, class Index>
+void HashTable<Hash, Index>::Resize(int newSize) {
+	STATS(statRehashes++);
+	vector<int> old;
+	for (int i = 0; i < size; i++) {
+		if (IsUsed(i)) old.push_back(keys[i]);		//Collect every key in the old table
 	}
-	for (i = size / 2; i < size; i++) {				//Fill second half with empty values
-		temp[i].Set_key(-1);
-		temp[i].Set_index(-1);
+	FreeTable();									//Free old table, create the new one [same address factor,
+	delete[] chainOf;								//so the divisor grows with the size]
+	delete[] chainTail;
+	chainOf = NULL;
+	chainTail = NULL;
+	CreateTable(newSize, addressFactor);
+	for (size_t i = 0; i < old.size(); i++) {
+		Insert(old[i]);								//Re-hash every key into the new table
 	}
-	delete table;									//Free old table, reassign to new table
-	table = temp;
 }
 
-void HashTable::Add(Node temp) {
-	int hashed = hash(temp.Get_key());
-	
-	if (table[hashed].Get_key() == -1) {
-		table[hashed].Set_key(temp.Get_key());		//First Case: If hash location is empty, add at that location
+template <class Hash, class Index>
+void HashTable<Hash, Index>::Reserve(int n) {
+	if (keys == NULL) {
+		CreateTable(n, addressFactor);
 		return;
 	}
+	long long newSize = size;
+	while (newSize < n) newSize *= 2;				//Same sizes doubling would reach, in one resize
+	if (newSize > MaxSize()) newSize = MaxSize();
+	if (newSize != size) Resize((int)newSize);
+}
+
+template <class Hash, class Index>
+void HashTable<Hash, Index>::BuildFrom(const int* newKeys, int n) {
+	long long newSize = (keys == NULL || size < 1) ? n : size;
+	while (newSize < n) newSize *= 2;				//Same size Reserve(n) would pick
+	if (newSize < 1) newSize = 1;
+	if (newSize > MaxSize()) newSize = MaxSize();
+	FreeTable();									//Start from an empty table of that size
+	CreateTable((int)newSize, addressFactor);
+
+	for (int i = 0; i < size; i++) {				//Every slot starts as a chain of its own [in order, instead
+		chainOf[i] = (Index)i;						//of one random write per key]
+		chainTail[i] = (Index)i;
+	}
 
-	for (int i = 1; i < size; i++) {						//Second Case: If hash location is full, probe until empty cell is found and add
-		if (table[(hashed + i) % size].Get_key() == -1) {
-			table[hashed + i].Set_key(temp.Get_key());
-			Node* list = &table[hashed];
-			while (list->Get_index() != -1) list = &table[list->Get_index()];
-			list->Set_index(hashed + i);
+	vector<int> overflow;							//First pass: every key whose home slot is empty takes it
+	for (int i = 0; i < n; i++) {
+		int hashed = hash(newKeys[i]);
+		if (IsUsed(hashed)) {
+			overflow.push_back(newKeys[i]);			//Home slot taken: link it once all home slots are placed
+			continue;
+		}
+		keys[hashed] = newKeys[i];
+		SetUsed(hashed, true);
+	}
+
+	for (size_t i = 0; i < overflow.size(); i++) {	//Second pass: free slots from the R pointer, linked at the
+		if (!Insert(overflow[i])) {					//chain tails [one pass over the table in all]
+			cerr << "HashTable: table is full [" << size << " slots is the most Index can address]\n";
 			return;
 		}
 	}
+}
 
-	Resize();												//If no empty cell if found, resize the table
+template <class Hash, class Index>
+void HashTable<Hash, Index>::RebuildChains() {
+	delete[] chainOf;
+	delete[] chainTail;
+	chainOf = new Index[size];
+	chainTail = new Index[size];
+	vector<bool> linkedTo(size, false);
+	for (int i = 0; i < size; i++) {
+		if (IsUsed(i) && Next(i) != -1) linkedTo[Next(i)] = true;
+	}
+	for (int i = 0; i < size; i++) {							//A slot in use that no slot links to starts a chain:
+		if (linkedTo[i] || !IsUsed(i)) continue;
+		int last = i;											//walk it to find its tail
+		for (int j = i; j != -1; j = Next(j)) {
+			chainOf[j] = (Index)i;
+			last = j;
+		}
+		chainTail[i] = (Index)last;
+	}
+	freeSlots.clear();
+	freeTop = size;
+	chainsBuilt = true;
+}
 
-	for (int i = 1; i < size; i++) {
-		if (table[(hashed + i) % size].Get_key() == -1) {		//Re-find new index after resizing table
-			table[hashed + i].Set_key(temp.Get_key());
-			Node* list = &table[hashed];
-			while (list->Get_index() != -1) list = &table[list->Get_index()];
-			list->Set_index(hashed + i);
+template <class Hash, class Index>
+int HashTable<Hash, Index>::FreeSlot() {
+	while (!freeSlots.empty()) {
+		int i = freeSlots.back();								//Slots freed by Remove first [skipping any that
+		freeSlots.pop_back();									//a home insert has taken since]
+		if (!IsUsed(i)) return i;
+	}
+	while (freeTop > 0) {										//Then the R pointer: moves down from the top of the
+		int word = (freeTop - 1) >> 6;							//table and never goes back up, so the scans of all
+		unsigned long long empty = ~used[word];					//inserts add up to one pass over the table
+		int below = freeTop - (word << 6);
+		if (below < 64) empty &= (1ull << below) - 1;			//Only slots below freeTop [64 slots per step]
+		if (empty != 0) {
+			freeTop = (word << 6) + HighestBit(empty);
+			return freeTop;
+		}
+		freeTop = word << 6;
+	}
+	return -1;
+}
+
+template <class Hash, class Index>
+void HashTable<Hash, Index>::Add(Node temp) {
+	if (!chainsBuilt) RebuildChains();
+	if (!Insert(temp.Get_key())) {
+		if (size == MaxSize()) {
+			cerr << "HashTable: table is full [" << size << " slots is the most Index can address]\n";
 			return;
 		}
+		Resize((size > MaxSize() / 2) ? MaxSize() : size * 2);	//If no empty cell is found, resize the table
+		Insert(temp.Get_key());
 	}
 }
 
-void HashTable::Remove(int key) {
+template <class Hash, class Index>
+bool HashTable<Hash, Index>::Insert(int key) {
+	int hashed = hash(key);
+	
+	if (!IsUsed(hashed)) {
+		keys[hashed] = key;							//First Case: If hash location is empty, add at that location
+		SetUsed(hashed, true);						//[it starts a new chain, free slots already have no next]
+		chainOf[hashed] = (Index)hashed;
+		chainTail[hashed] = (Index)hashed;
+		return true;
+	}
+
+	int free = FreeSlot();							//Second Case: If hash location is full, take a free slot
+	if (free == -1) return false;
+
+	int chain = chainOf[hashed];
+	keys[free] = key;								//Link the slot after the tail of the chain [no walk needed]
+	SetUsed(free, true);
+	SetNext(chainTail[chain], free);
+	chainOf[free] = (Index)chain;
+	chainTail[chain] = (Index)free;
+	return true;
+}
+
+template <class Hash, class Index>
+void HashTable<Hash, Index>::Remove(int key) {
+	if (!chainsBuilt) RebuildChains();
 	int target = hash(key);
 
-	if (table[target].Get_key() == -1) return;				//If key index is empty, there is no node to remove so return
+	if (!IsUsed(target)) return;							//If key index is empty, there is no node to remove so return
 
-	if (table[target].Get_key() == key) {
-		if (table[target].Get_index() == -1) {
-			table[target].Set_key(-1);						//If key is at index, move node that is next in the chain to
-			return;											//index, then return
-		}
-		Node* nextChain = &table[table[target].Get_index()];
-		table[target].Set_key(nextChain->Get_key());
-		table[target].Set_index(nextChain->Get_index());
-		nextChain->Set_index(-1);
-		nextChain->Set_key(-1);
-		return;
+	while (target != -1 && keys[target] != key) {
+		target = Next(target);								//Traverse through chain looking for key
 	}
-	Node* chainTraverse = &table[target];
-	while (chainTraverse->Get_index() != -1) {				//Traverse through chain looking for key, if found, remove node
-		Node* test = &table[chainTraverse->Get_index()];	//[set to empty], and rebuild chain around node
-		if (test->Get_key() == key) {
-			chainTraverse->Set_index(test->Get_index());
-			test->Set_index(-1);
-			test->Set_key(-1);
-			return;
-		}
-		chainTraverse = &table[chainTraverse->Get_index()];
+	if (target == -1) return;								//If key is never found, return without doing anything
+
+	int chain = chainOf[target];							//Find the slot before it [walk from the start of its chain]
+	int prev = -1;
+	if (target != chain) {
+		prev = chain;
+		while (Next(prev) != target) prev = Next(prev);
 	}
-}															//If key is never found, return without doing anything
+
+	vector<int> moved;										//Cut the chain at the node: free it and every slot after
+	int i = target;											//it, keeping the keys that were after it
+	while (i != -1) {
+		int n = Next(i);
+		if (i != target) moved.push_back(keys[i]);
+		SetNext(i, -1);
+		SetUsed(i, false);
+		freeSlots.push_back(i);
+		i = n;
+	}
+	if (prev != -1) {
+		SetNext(prev, -1);
+		chainTail[chain] = (Index)prev;
+	}
+
+	for (size_t j = 0; j < moved.size(); j++) {
+		Insert(moved[j]);									//Add those keys again: each lands in its home slot or on
+	}														//its home slot's chain [never fails, slots were just freed]
+}
 
 // Constructor
-HashTable::HashTable() {
-	table = NULL;
+template <class Hash, class Index>
+HashTable<Hash, Index>::HashTable() {
+	keys = NULL;
+	next = NULL;
+	used = NULL;
 	size = 0;
 	origDiv = 0;
+	addressFactor = 1.0;
+	mapBase = NULL;
+	mapLength = 0;
+	chainOf = NULL;
+	chainTail = NULL;
+	freeTop = 0;
+	chainsBuilt = false;
+	statHits = 0;
+	statMisses = 0;
+	statHitProbes = 0;
+	statMissProbes = 0;
+	statRehashes = 0;
+}
+
+// Destructor
+template <class Hash, class Index>
+HashTable<Hash, Index>::~HashTable() {
+	FreeTable();
+	delete[] chainOf;
+	delete[] chainTail;
+}
+
+template <class Hash, class Index>
+void HashTable<Hash, Index>::FreeTable() {
+#if HASH_MMAP
+	if (mapBase != NULL) {
+		munmap(mapBase, mapLength);					//Table lives in a mapped snapshot
+		mapBase = NULL;
+		mapLength = 0;
+		keys = NULL;
+		next = NULL;
+		used = NULL;
+		return;
+	}
+#endif
+	delete[] keys;
+	delete[] next;
+	delete[] used;
+	keys = NULL;
+	next = NULL;
+	used = NULL;
+}
+
+template <class Hash, class Index>
+bool HashTable<Hash, Index>::CheckHeader(const SnapshotHeader& header) {
+	return memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0
+		&& header.indexSize == (int)sizeof(Index)
+		&& header.hashCheck == Hash::Hash(SNAPSHOT_CHECK_KEY)
+		&& header.origDiv > 0 && header.size >= header.origDiv && header.size <= MaxSize();
+}
+
+//
+// Snapshot arrays follow the header in this order: used [8-byte words],
+// keys, next, so each starts aligned for its type
+//
+template <class Hash, class Index>
+size_t HashTable<Hash, Index>::SnapshotLength(int n) {
+	return sizeof(SnapshotHeader) + (size_t)(n + 63) / 64 * sizeof(unsigned long long)
+		+ (size_t)n * sizeof(int) + (size_t)n * sizeof(Index);
+}
+
+template <class Hash, class Index>
+void HashTable<Hash, Index>::SetArrays(char* base) {
+	used = (unsigned long long*)(base + sizeof(SnapshotHeader));
+	keys = (int*)(used + (size + 63) / 64);
+	next = (Index*)(keys + size);
+}
+
+template <class Hash, class Index>
+bool HashTable<Hash, Index>::Save(const char* path) {
+	ofstream out(path, ios::binary);
+	if (!out) return false;
+
+	SnapshotHeader header;
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header.size = size;
+	header.origDiv = origDiv;
+	header.indexSize = sizeof(Index);
+	header.hashCheck = Hash::Hash(SNAPSHOT_CHECK_KEY);
+	out.write((const char*)&header, sizeof(header));
+	out.write((const char*)used, (streamsize)((size + 63) / 64) * sizeof(unsigned long long));	//Arrays as they are: one write each
+	out.write((const char*)keys, (streamsize)size * sizeof(int));
+	out.write((const char*)next, (streamsize)size * sizeof(Index));
+	return (bool)out;
+}
+
+template <class Hash, class Index>
+bool HashTable<Hash, Index>::Load(const char* path) {
+	ifstream in(path, ios::binary);
+	if (!in) return false;
+
+	SnapshotHeader header;
+	if (!in.read((char*)&header, sizeof(header)) || !CheckHeader(header)) return false;
+
+	int n = header.size;
+	int words = (n + 63) / 64;
+	unsigned long long* newUsed = new unsigned long long[words];
+	int* newKeys = new int[n];
+	Index* newNext = new Index[n];
+	in.read((char*)newUsed, (streamsize)words * sizeof(unsigned long long));	//Arrays as they are: one read each
+	in.read((char*)newKeys, (streamsize)n * sizeof(int));
+	in.read((char*)newNext, (streamsize)n * sizeof(Index));
+	if (!in) {
+		delete[] newUsed;
+		delete[] newKeys;
+		delete[] newNext;
+		return false;
+	}
+	FreeTable();
+	used = newUsed;
+	keys = newKeys;
+	next = newNext;
+	size = n;
+	origDiv = header.origDiv;
+	addressFactor = (double)origDiv / size;
+	chainsBuilt = false;
+	return true;
+}
+
+template <class Hash, class Index>
+bool HashTable<Hash, Index>::Map(const char* path) {
+#if HASH_MMAP
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return false;
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(SnapshotHeader)) {
+		close(fd);
+		return false;
+	}
+	size_t length = (size_t)info.st_size;
+	void* base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);										//The mapping stays valid after the file is closed
+	if (base == MAP_FAILED) return false;
+
+	SnapshotHeader* header = (SnapshotHeader*)base;
+	if (!CheckHeader(*header) || length != SnapshotLength(header->size)) {
+		munmap(base, length);
+		return false;
+	}
+	FreeTable();
+	mapBase = (char*)base;
+	mapLength = length;
+	size = header->size;
+	origDiv = header->origDiv;
+	addressFactor = (double)origDiv / size;
+	SetArrays(mapBase);								//The arrays are used where they are in the mapping
+	chainsBuilt = false;
+	return true;
+#else
+	return Load(path);
+#endif
 }
 
-int HashTable::Get_Size() {
+template <class Hash, class Index>
+int HashTable<Hash, Index>::Get_Size() {
 	return size;			//Returns table size
 }
 
+template <class Hash, class Index>
+int HashTable<Hash, Index>::RecordSearch(int result, int probes) {
+	STATS(
+		if (result != -1) {
+			statHits++;
+			statHitProbes += probes;
+		}
+		else {
+			statMisses++;
+			statMissProbes += probes;
+		}
+	)
+	(void)probes;						//Unused when HASH_STATS is 0
+	return result;
+}
+
+template <class Hash, class Index>
+TableStats HashTable<Hash, Index>::GetStats() {
+	TableStats stats;
+	stats.count = 0;
+	stats.size = size;
+	stats.maxChain = 0;
+	for (int i = 0; i < STATS_HISTOGRAM_SIZE; i++) stats.histogram[i] = 0;
+	for (int i = 0; i < size; i++) {
+		int length = 0;
+		if (IsUsed(i)) {
+			stats.count++;
+			for (int j = i; j != -1; j = Next(j)) length++;				//Walk the chain the way Search does
+		}
+		if (i >= origDiv) continue;										//Searches never start in the cellar
+		if (length > stats.maxChain) stats.maxChain = length;
+		stats.histogram[(length < STATS_HISTOGRAM_SIZE - 1) ? length : STATS_HISTOGRAM_SIZE - 1]++;
+	}
+	stats.loadFactor = (size > 0) ? (double)stats.count / size : 0;
+
+	stats.hits = statHits;
+	stats.misses = statMisses;
+	stats.avgProbesHit = (statHits > 0) ? (double)statHitProbes / statHits : 0;
+	stats.avgProbesMiss = (statMisses > 0) ? (double)statMissProbes / statMisses : 0;
+	stats.rehashes = statRehashes;
+	return stats;
+}
+
+template <class Hash, class Index>
+void HashTable<Hash, Index>::PrintStats() {
+	TableStats stats = GetStats();
+	cout << "count " << stats.count << '\n';
+	cout << "size " << stats.size << '\n';
+	cout << "load factor " << stats.loadFactor << '\n';
+	cout << "max chain " << stats.maxChain << '\n';
+	cout << "chain lengths";
+	for (int i = 0; i < STATS_HISTOGRAM_SIZE; i++) cout << ' ' << stats.histogram[i];
+	cout << '\n';
+	cout << "probes per hit " << stats.avgProbesHit << " (" << stats.hits << " searches)" << '\n';
+	cout << "probes per miss " << stats.avgProbesMiss << " (" << stats.misses << " searches)" << '\n';
+	cout << "rehashes " << stats.rehashes << '\n';
+}
+
 //First Print Function
-void HashTable::PrintTable() {
+template <class Hash, class Index>
+void HashTable<Hash, Index>::PrintTable() {
 	for (int i = 0; i < size; i++) {
-		cout << table[i].Get_key() << '\n';
+		if (IsUsed(i)) cout << keys[i] << '\n';
+		else cout << -1 << '\n';
 	}
 }
 
 
 // 2nd Print Function
-void HashTable::PrintChain(int key) {
+template <class Hash, class Index>
+void HashTable<Hash, Index>::PrintChain(int key) {
 	int temp = hash(key);
+	if (!IsUsed(temp)) {
+		cout << -1 << '\n';
+		return;
+	}
 	while (temp != -1) {
-		cout << table[temp].Get_key() << '\n';
-		temp = table[temp].Get_index();
+		cout << keys[temp] << '\n';
+		temp = Next(temp);
 	}
 }
 
 
+//
+// The ConcurrentHashTable class is a coalesced chaining table for tables
+// that are read from many threads and written rarely
+//
+// One writer at a time [Add/Remove take writerLock, so writers queue up]
+// changes the table under a sequence counter: the counter is odd while a
+// change is in progress and goes up by two for every change. Readers
+// [Search] take no lock: they read the counter, search, and read it again,
+// and search again if it changed [or was odd] in between. The table's
+// arrays are atomics so a reader can run into a half finished change
+// without undefined behavior, it just retries
+//
+// Resizing builds the new table on the side and publishes it by swapping
+// one atomic pointer. Old tables are kept until the table is destroyed,
+// since a reader may still be searching them [tables double, so all old
+// tables together are smaller than the current one]
+//
+// Slots, chains, the cellar and Remove work like HashTable
+//
+template <class Hash = MurmurHash, class Index = int>
+class ConcurrentHashTable {
+
+private:
+
+	// One version of the table [replaced as a whole when the table resizes]
+	struct Table {
+		int size;
+		int origDiv;
+		atomic<int>* keys;
+		atomic<Index>* next;
+		atomic<unsigned long long>* used;
+	};
+
+	atomic<Table*> table;
+
+	// Tables replaced by a resize [freed by the destructor]
+	vector<Table*> retired;
+
+	// Even when no change is in progress
+	atomic<unsigned> sequence;
+
+	// Taken by Add and Remove
+	mutex writerLock;
+
+	double addressFactor;
+	atomic<int> count;
+
+	// Next index meaning "end of chain"
+	static const Index NO_SLOT = (Index)-1;
+
+	// Writer-only state [same as HashTable's, for the current table]
+	vector<Index> chainOf;
+	vector<Index> chainTail;
+	vector<int> freeSlots;
+	int freeTop;
+
+	// Allocates an empty table with size slots
+	Table* NewTable(int size);
+
+	// Frees a table's arrays and the table
+	static void FreeTable(Table* t);
+
+	// Starts and ends a change readers must not see half done
+	void BeginWrite();
+	void EndWrite();
+
+	// Slot access [relaxed atomics, ordering comes from the sequence counter]
+	static bool IsUsed(Table* t, int slot);
+	static void SetUsed(Table* t, int slot, bool inUse);
+	static int Next(Table* t, int slot);
+	static void SetNext(Table* t, int slot, int n);
+
+	// Returns a free slot of t [-1 if it is full]
+	int FreeSlot(Table* t);
+
+	// Adds key to t without resizing, returns false if t is full
+	bool Insert(Table* t, int key);
+
+	// Builds a table of newSize slots with every key and publishes it
+	void Resize(int newSize);
+
+	// Largest size an Index can address
+	static int MaxSize();
+
+public:
+
+	//
+	// Creates a table with "divisor" slots [and a cellar if factor is below 1,
+	// see HashTable::CreateTable]
+	//
+	void CreateTable(int divisor, double factor = 1.0);
+
+	//
+	// Returns true if a student whose SID = key is in the table
+	// [takes no lock, safe to call while another thread writes]
+	//
+	bool Search(int key);
+
+	//
+	// Adds a student with SID = key to the table
+	// Returns false, leaving the table unchanged, if it is full and
+	// already has as many slots as Index can address
+	//
+	bool Add(int key);
+
+	//
+	// Removes a student whose SID = key from the table
+	// If the student is not in the table, it does nothing
+	//
+	void Remove(int key);
+
+	//
+	// Returns the number of slots in the table
+	//
+	int Get_Size();
+
+	//
+	// Returns the number of students stored in the table
+	//
+	int Get_Count();
+
+	ConcurrentHashTable();
+	~ConcurrentHashTable();
+};
+
+template <class Hash, class Index>
+ConcurrentHashTable<Hash, Index>::ConcurrentHashTable() {
+	table.store(NULL);
+	sequence.store(0);
+	addressFactor = 1.0;
+	count.store(0);
+	freeTop = 0;
+}
+
+template <class Hash, class Index>
+ConcurrentHashTable<Hash, Index>::~ConcurrentHashTable() {
+	FreeTable(table.load());
+	for (size_t i = 0; i < retired.size(); i++) FreeTable(retired[i]);
+}
+
+template <class Hash, class Index>
+typename ConcurrentHashTable<Hash, Index>::Table* ConcurrentHashTable<Hash, Index>::NewTable(int size) {
+	Table* t = new Table;
+	t->size = size;
+	t->origDiv = (int)(size * addressFactor + 0.5);	//Address region, the rest of the table is the cellar
+	if (t->origDiv < 1) t->origDiv = 1;
+	if (t->origDiv > size) t->origDiv = size;
+	int words = (size + 63) / 64;
+	t->keys = new atomic<int>[size];
+	t->next = new atomic<Index>[size];
+	t->used = new atomic<unsigned long long>[words];
+	for (int i = 0; i < size; i++) {
+		t->keys[i].store(0, memory_order_relaxed);
+		t->next[i].store(NO_SLOT, memory_order_relaxed);
+	}
+	for (int i = 0; i < words; i++) t->used[i].store(0, memory_order_relaxed);
+
+	chainOf.assign(size, (Index)NO_SLOT);			//Writer state now describes the new table
+	chainTail.assign(size, (Index)NO_SLOT);
+	freeSlots.clear();
+	freeTop = size;
+	return t;
+}
+
+template <class Hash, class Index>
+void ConcurrentHashTable<Hash, Index>::FreeTable(Table* t) {
+	if (t == NULL) return;
+	delete[] t->keys;
+	delete[] t->next;
+	delete[] t->used;
+	delete t;
+}
+
+template <class Hash, class Index>
+void ConcurrentHashTable<Hash, Index>::BeginWrite() {
+	sequence.store(sequence.load(memory_order_relaxed) + 1, memory_order_relaxed);	//Odd: change in progress
+	atomic_thread_fence(memory_order_release);		//[no change to the table can be seen before the odd count]
+}
+
+template <class Hash, class Index>
+void ConcurrentHashTable<Hash, Index>::EndWrite() {
+	sequence.store(sequence.load(memory_order_relaxed) + 1, memory_order_release);	//Even: change is complete
+}
+
+template <class Hash, class Index>
+bool ConcurrentHashTable<Hash, Index>::IsUsed(Table* t, int slot) {
+	return (t->used[slot >> 6].load(memory_order_relaxed) >> (slot & 63)) & 1;
+}
+
+template <class Hash, class Index>
+void ConcurrentHashTable<Hash, Index>::SetUsed(Table* t, int slot, bool inUse) {
+	unsigned long long word = t->used[slot >> 6].load(memory_order_relaxed);	//Only the writer changes bits
+	if (inUse) word |= 1ull << (slot & 63);
+	else word &= ~(1ull << (slot & 63));
+	t->used[slot >> 6].store(word, memory_order_relaxed);
+}
+
+template <class Hash, class Index>
+int ConcurrentHashTable<Hash, Index>::Next(Table* t, int slot) {
+	Index n = t->next[slot].load(memory_order_relaxed);
+	return (n == NO_SLOT) ? -1 : (int)n;
+}
+
+template <class Hash, class Index>
+void ConcurrentHashTable<Hash, Index>::SetNext(Table* t, int slot, int n) {
+	t->next[slot].store((n == -1) ? NO_SLOT : (Index)n, memory_order_relaxed);
+}
+
+template <class Hash, class Index>
+int ConcurrentHashTable<Hash, Index>::MaxSize() {
+	return (numeric_limits<Index>::max() < INT_MAX) ? (int)numeric_limits<Index>::max() : INT_MAX;
+}
+
+template <class Hash, class Index>
+void ConcurrentHashTable<Hash, Index>::CreateTable(int divisor, double factor) {
+	if (divisor > MaxSize()) divisor = MaxSize();	//Index can't address more slots
+	addressFactor = factor;
+	table.store(NewTable(divisor), memory_order_release);
+}
+
+template <class Hash, class Index>
+bool ConcurrentHashTable<Hash, Index>::Search(int key) {
+	unsigned h = Hash::Hash(key);
+	while (true) {
+		unsigned before = sequence.load(memory_order_acquire);
+		if (before & 1) {
+			this_thread::yield();					//A change is in progress: its result is coming, try again
+			continue;
+		}
+
+		Table* t = table.load(memory_order_acquire);
+		int slot = (int)Reduce(h, (unsigned)t->origDiv);
+		bool found = false;
+		if (IsUsed(t, slot)) {
+			for (int steps = 0; slot != -1 && steps < t->size; steps++) {	//Bounded: a change seen half done could
+				if (t->keys[slot].load(memory_order_relaxed) == key) {		//have linked a loop
+					found = true;
+					break;
+				}
+				slot = Next(t, slot);
+			}
+		}
+
+		atomic_thread_fence(memory_order_acquire);	//Every read above happens before the second count
+		if (sequence.load(memory_order_relaxed) == before) return found;	//No change ran meanwhile: the answer holds
+	}
+}
+
+template <class Hash, class Index>
+int ConcurrentHashTable<Hash, Index>::FreeSlot(Table* t) {
+	while (!freeSlots.empty()) {
+		int i = freeSlots.back();					//Slots freed by Remove first, then the R pointer
+		freeSlots.pop_back();						//[see HashTable::FreeSlot]
+		if (!IsUsed(t, i)) return i;
+	}
+	while (freeTop > 0) {
+		int word = (freeTop - 1) >> 6;
+		unsigned long long empty = ~t->used[word].load(memory_order_relaxed);
+		int below = freeTop - (word << 6);
+		if (below < 64) empty &= (1ull << below) - 1;
+		if (empty != 0) {
+			freeTop = (word << 6) + HighestBit(empty);
+			return freeTop;
+		}
+		freeTop = word << 6;
+	}
+	return -1;
+}
+
+template <class Hash, class Index>
+bool ConcurrentHashTable<Hash, Index>::Insert(Table* t, int key) {
+	int hashed = (int)Reduce(Hash::Hash(key), (unsigned)t->origDiv);
+	if (!IsUsed(t, hashed)) {
+		t->keys[hashed].store(key, memory_order_relaxed);	//Empty home slot: starts a new chain
+		SetUsed(t, hashed, true);
+		chainOf[hashed] = (Index)hashed;
+		chainTail[hashed] = (Index)hashed;
+		return true;
+	}
+
+	int free = FreeSlot(t);
+	if (free == -1) return false;
+	int chain = chainOf[hashed];
+	t->keys[free].store(key, memory_order_relaxed);	//Link a free slot after the tail of the home slot's chain
+	SetUsed(t, free, true);
+	SetNext(t, chainTail[chain], free);
+	chainOf[free] = (Index)chain;
+	chainTail[chain] = (Index)free;
+	return true;
+}
+
+template <class Hash, class Index>
+void ConcurrentHashTable<Hash, Index>::Resize(int newSize) {
+	Table* old = table.load(memory_order_relaxed);
+	Table* t = NewTable(newSize);					//Filled while readers still use the old table
+	for (int i = 0; i < old->size; i++) {
+		if (IsUsed(old, i)) Insert(t, old->keys[i].load(memory_order_relaxed));
+	}
+	BeginWrite();
+	table.store(t, memory_order_release);			//Publish: readers that started on the old table retry
+	EndWrite();
+	retired.push_back(old);
+}
+
+template <class Hash, class Index>
+bool ConcurrentHashTable<Hash, Index>::Add(int key) {
+	lock_guard<mutex> guard(writerLock);
+	Table* t = table.load(memory_order_relaxed);
+	BeginWrite();
+	bool added = Insert(t, key);
+	EndWrite();
+	if (!added) {
+		if (t->size == MaxSize()) {
+			cerr << "ConcurrentHashTable: table is full [" << t->size << " slots is the most Index can address]\n";
+			return false;
+		}
+		Resize((t->size > MaxSize() / 2) ? MaxSize() : t->size * 2);	//Full: double the table, then add to the new one
+		t = table.load(memory_order_relaxed);
+		BeginWrite();
+		Insert(t, key);
+		EndWrite();
+	}
+	count.fetch_add(1, memory_order_relaxed);
+	return true;
+}
+
+template <class Hash, class Index>
+void ConcurrentHashTable<Hash, Index>::Remove(int key) {
+	lock_guard<mutex> guard(writerLock);
+	Table* t = table.load(memory_order_relaxed);
+	int target = (int)Reduce(Hash::Hash(key), (unsigned)t->origDiv);
+	if (!IsUsed(t, target)) return;
+	while (target != -1 && t->keys[target].load(memory_order_relaxed) != key) target = Next(t, target);
+	if (target == -1) return;						//Not in the table: nothing to publish
+
+	int chain = chainOf[target];					//Same steps as HashTable::Remove: cut the chain at the
+	int prev = -1;									//node, free the rest of it and add those keys again
+	if (target != chain) {
+		prev = chain;
+		while (Next(t, prev) != target) prev = Next(t, prev);
+	}
+
+	BeginWrite();
+	vector<int> moved;
+	int i = target;
+	while (i != -1) {
+		int n = Next(t, i);
+		if (i != target) moved.push_back(t->keys[i].load(memory_order_relaxed));
+		SetNext(t, i, -1);
+		SetUsed(t, i, false);
+		freeSlots.push_back(i);
+		i = n;
+	}
+	if (prev != -1) {
+		SetNext(t, prev, -1);
+		chainTail[chain] = (Index)prev;
+	}
+	for (size_t j = 0; j < moved.size(); j++) Insert(t, moved[j]);
+	EndWrite();
+	count.fetch_sub(1, memory_order_relaxed);
+}
+
+template <class Hash, class Index>
+int ConcurrentHashTable<Hash, Index>::Get_Size() {
+	return table.load(memory_order_acquire)->size;
+}
+
+template <class Hash, class Index>
+int ConcurrentHashTable<Hash, Index>::Get_Count() {
+	return count.load(memory_order_relaxed);
+}
+
+
 // 
 // Main Function: Testing
 // 
@@ -281,20 +1331,29 @@ int main()
 	// Used by the hash function and CreateTable() function 
 	int divisor;
 
+	// Address factor given to CreateTable() [read after the divisor in
+	// modes 7 and 8, 1.0 = no cellar otherwise]
+	double factor = 1.0;
+
 	
 	Node Student;
 
-	HashTable x;
+	HashTable<> x;
+
+	// Every key read, in order [used by BuildFrom]
+	vector<int> input;
 
 	cin >> mode >> key >> key_chain >> divisor;
+	if (mode == 7 || mode == 8) cin >> factor;
 
-	x.CreateTable(divisor);
+	x.CreateTable(divisor, factor);
 
 	while (cin >> temp) {
 
 		Student.Set_key(temp);
 
 		x.Add(Student); 
+		input.push_back(temp);
 	}
 
 	// Mode 0: test the "Add" function and the resizing/rehashing processes. 
@@ -319,6 +1378,86 @@ int main()
 		x.PrintChain(key);
 	}
 
+	// Mode 4: test the statistics [after searching for key]
+	else if (mode == 4) {
+		x.Search(key);
+		x.PrintStats();
+	}
+
+	// Mode 5: test "Save" and "Map" [prints the mapped copy of the table]
+	else if (mode == 5) {
+		HashTable<> copy;
+		if (x.Save("coalesced.snapshot") && copy.Map("coalesced.snapshot")) {
+			copy.PrintTable();
+			copy.PrintChain(key_chain);
+		}
+		remove("coalesced.snapshot");
+	}
+
+	// Mode 6: test "BuildFrom" [same keys, built in one go]
+	else if (mode == 6) {
+		HashTable<> built;
+		built.CreateTable(divisor);
+		built.BuildFrom(input.data(), (int)input.size());
+		built.PrintTable();
+		built.PrintChain(key_chain);
+	}
+
+	// Mode 7: test the cellar [table built with the address factor read
+	// after the divisor, prints it and its statistics after searching key]
+	else if (mode == 7) {
+		x.Search(key);
+		x.PrintTable();
+		x.PrintStats();
+	}
+
+	// Mode 8: test "Reserve" [a table of "divisor" slots reserves room for
+	// every student, then they are added: prints the number of resizes
+	// while adding (0), then the statistics]
+	else if (mode == 8) {
+		HashTable<> reserved;
+		reserved.CreateTable(divisor, factor);
+		reserved.Reserve((int)input.size());
+		int reserveRehashes = reserved.GetStats().rehashes;
+		for (size_t i = 0; i < input.size(); i++) {
+			Student.Set_key(input[i]);
+			reserved.Add(Student);
+		}
+		cout << reserved.GetStats().rehashes - reserveRehashes << '\n';
+		reserved.PrintStats();
+	}
+
+	// Mode 9: test a table with 16-bit slot indexes [same students: prints
+	// the result of mode 2, then that of mode 3]
+	else if (mode == 9) {
+		HashTable<IdentityHash, unsigned short> narrow;
+		narrow.CreateTable(divisor);
+		for (size_t i = 0; i < input.size(); i++) {
+			Student.Set_key(input[i]);
+			narrow.Add(Student);
+		}
+		cout << narrow.Search(key) << '\n';
+		narrow.Remove(key);
+		narrow.PrintTable();
+		narrow.PrintChain(key);
+	}
+
+	// Mode 10: test ConcurrentHashTable [one thread adds the students while
+	// this one searches for key, then prints: found (1/0), found after
+	// removing key, and the number of students left]
+	else if (mode == 10) {
+		ConcurrentHashTable<> c;
+		c.CreateTable(divisor, factor);
+		thread writer([&c, &input]() {
+			for (size_t i = 0; i < input.size(); i++) c.Add(input[i]);
+		});
+		for (int i = 0; i < 1000; i++) c.Search(key);
+		writer.join();
+		cout << c.Search(key) << ' ';
+		c.Remove(key);
+		cout << c.Search(key) << ' ' << c.Get_Count();
+	}
+
 	return 0;
 }
 
@@ -4,6 +4,7 @@
 // does not actually implement the tree actions/properties [Can be seen in next file]
 // 
 // Traverse Algorithms: Pre-Order, In-Order, Post-Order, Breadth-First
+// [recursive, with an explicit stack, and Morris (no stack at all)]
 // 
 // It also implements a Convert function that uses a Breadth-First algorithm to convert
 // the Binary Tree into an array
@@ -12,6 +13,7 @@
 #include <iostream>
 #include <cmath>
 #include <queue>
+#include <stack>
 using namespace std;
 
 //
@@ -101,15 +103,14 @@ void Traverse(Node* p, string s) {
 		cout << p->Get_key();
 	}
 	else if (s == "bf") {
-		queue<Node*>* x = new queue<Node*>;							//Breadth-First: NOT RECURSIVE --> Uses queue to keep track of nodes and their
-		x->push(p);													//children, printing out one by one
-		while (!x->empty()) {
-			if (x->front()->Get_left() != NULL) x->push(x->front()->Get_left());
-			if (x->front()->Get_right() != NULL) x->push(x->front()->Get_right());
-			cout << x->front()->Get_key();
-			x->pop();
+		queue<Node*> x;												//Breadth-First: NOT RECURSIVE --> Uses queue to keep track of nodes and their
+		x.push(p);													//children, printing out one by one
+		while (!x.empty()) {
+			if (x.front()->Get_left() != NULL) x.push(x.front()->Get_left());
+			if (x.front()->Get_right() != NULL) x.push(x.front()->Get_right());
+			cout << x.front()->Get_key();
+			x.pop();
 		}
-		delete x;
 	}
 	else {
 		cout << -1;													//If none of the key strings are picked up, return -1
@@ -118,6 +119,168 @@ void Traverse(Node* p, string s) {
 
 
 
+// 
+// Same as Traverse [same "s" values, same output], but keeps the nodes still
+// to be visited on an explicit stack instead of the call stack, so a deep
+// [e.g. skewed] tree of millions of nodes can't overflow it
+// 
+void TraverseIterative(Node* p, string s) {
+	if (p == NULL) return;
+	if (p->Get_left() == NULL && p->Get_right() == NULL) {
+		cout << p->Get_key();										//Leaf: printed for any "s", as in Traverse
+		return;
+	}
+
+	stack<Node*> x;
+	if (s == "pre") {
+		x.push(p);
+		while (!x.empty()) {
+			Node* cur = x.top();									//Pre-Order: print a node when it is popped, then push
+			x.pop();												//right before left so the left subtree comes out first
+			cout << cur->Get_key();
+			if (cur->Get_right() != NULL) x.push(cur->Get_right());
+			if (cur->Get_left() != NULL) x.push(cur->Get_left());
+		}
+	}
+	else if (s == "in") {
+		Node* cur = p;
+		while (cur != NULL || !x.empty()) {
+			while (cur != NULL) {									//In-Order: push the path down to the leftmost node,
+				x.push(cur);										//print it, then do the same for its right subtree
+				cur = cur->Get_left();
+			}
+			cur = x.top();
+			x.pop();
+			cout << cur->Get_key();
+			cur = cur->Get_right();
+		}
+	}
+	else if (s == "post") {
+		Node* cur = p;
+		Node* last = NULL;											//Last node printed
+		while (cur != NULL || !x.empty()) {
+			while (cur != NULL) {									//Post-Order: like in-order, but a node is only printed
+				x.push(cur);										//once its right subtree is done [its right child is
+				cur = cur->Get_left();								//NULL or was the last node printed]
+			}
+			Node* top = x.top();
+			if (top->Get_right() != NULL && top->Get_right() != last) {
+				cur = top->Get_right();
+			}
+			else {
+				cout << top->Get_key();
+				last = top;
+				x.pop();
+			}
+		}
+	}
+	else if (s == "bf") {
+		Traverse(p, s);												//Breadth-First is not recursive to begin with
+	}
+	else {
+		cout << -1;
+	}
+}
+
+// 
+// Prints keys from "to" back up to "from" along right pointers [from, ..., to
+// is a path of right children]. Reverses the path, prints it, and reverses
+// it back, so it needs no stack [used by Morris post-order]
+// 
+void PrintRightPathReversed(Node* from, Node* to) {
+	Node* prev = NULL;
+	Node* cur = from;
+	while (prev != to) {											//Reverse: each right pointer points back up
+		Node* next = cur->Get_right();
+		cur->Set_right(prev);
+		prev = cur;
+		cur = next;
+	}
+	cur = prev;														//prev is now "to", the head of the reversed path
+	prev = NULL;
+	while (prev != from) {											//Print and reverse again, restoring the path
+		cout << cur->Get_key();
+		Node* next = cur->Get_right();
+		cur->Set_right(prev);
+		prev = cur;
+		cur = next;
+	}
+}
+
+// 
+// Same as Traverse [same "s" values, same output], using Morris traversal:
+// no stack and no recursion, O(1) extra space for "pre", "in" and "post"
+// 
+// While a left subtree is walked, the right pointer of its last in-order node
+// [which is NULL] is pointed back at the subtree's parent, so the walk can
+// climb back without a stack. Every such link is removed on the way back, so
+// the tree is unchanged afterwards [but must not be used by another thread
+// meanwhile]. "bf" needs a queue and uses Traverse
+// 
+void TraverseMorris(Node* p, string s) {
+	if (p == NULL) return;
+	if (p->Get_left() == NULL && p->Get_right() == NULL) {
+		cout << p->Get_key();										//Leaf: printed for any "s", as in Traverse
+		return;
+	}
+
+	if (s == "pre" || s == "in") {
+		bool pre = (s == "pre");
+		Node* cur = p;
+		while (cur != NULL) {
+			if (cur->Get_left() == NULL) {
+				cout << cur->Get_key();								//No left subtree: print it, go right [right may be
+				cur = cur->Get_right();								//a link back up]
+				continue;
+			}
+			Node* last = cur->Get_left();							//Last in-order node of the left subtree [its right
+			while (last->Get_right() != NULL && last->Get_right() != cur) {	//is NULL, or the link back to cur]
+				last = last->Get_right();
+			}
+			if (last->Get_right() == NULL) {
+				if (pre) cout << cur->Get_key();					//First visit: link back, then walk the left subtree
+				last->Set_right(cur);								//[pre-order prints a node here]
+				cur = cur->Get_left();
+			}
+			else {
+				last->Set_right(NULL);								//Second visit [left subtree done]: remove the link
+				if (!pre) cout << cur->Get_key();					//[in-order prints a node here], then go right
+				cur = cur->Get_right();
+			}
+		}
+	}
+	else if (s == "post") {
+		Node dummy;													//Post-Order: in-order walk of a tree whose root is the
+		dummy.Set_left(p);											//left child of a dummy node. When a left subtree is
+		Node* cur = &dummy;											//done, print the right path from its root down to its
+		while (cur != NULL) {										//last node, bottom up
+			if (cur->Get_left() == NULL) {
+				cur = cur->Get_right();
+				continue;
+			}
+			Node* last = cur->Get_left();
+			while (last->Get_right() != NULL && last->Get_right() != cur) {
+				last = last->Get_right();
+			}
+			if (last->Get_right() == NULL) {
+				last->Set_right(cur);
+				cur = cur->Get_left();
+			}
+			else {
+				last->Set_right(NULL);
+				PrintRightPathReversed(cur->Get_left(), last);
+				cur = cur->Get_right();
+			}
+		}
+	}
+	else if (s == "bf") {
+		Traverse(p, s);
+	}
+	else {
+		cout << -1;
+	}
+}
+
 // 
 // Function measures height of a list-based tree/subtree held at "root"
 // 
@@ -236,6 +399,28 @@ int main()
 		};
 	}
 
+	// Mode 6: test explicit-stack traverse [pre, post, in, bf like modes 0-3]
+	else if (mode == 6) {
+		TraverseIterative(root, "pre");
+		cout << '\n';
+		TraverseIterative(root, "post");
+		cout << '\n';
+		TraverseIterative(root, "in");
+		cout << '\n';
+		TraverseIterative(root, "bf");
+	}
+
+	// Mode 7: test Morris traverse [pre, post, in, bf like modes 0-3]
+	else if (mode == 7) {
+		TraverseMorris(root, "pre");
+		cout << '\n';
+		TraverseMorris(root, "post");
+		cout << '\n';
+		TraverseMorris(root, "in");
+		cout << '\n';
+		TraverseMorris(root, "bf");
+	}
+
 	return 0;
 }
 